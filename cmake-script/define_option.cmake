@@ -16,6 +16,12 @@ ELSE(LONG_PROBABILITY)
 set(PROBABILITY "DOUBLE_PROB")
 ENDIF(LONG_PROBABILITY)
 
+if(BITSET_DOMAIN)
+set(DOMAINFLAG "BITSETDOMAIN")
+ELSE(BITSET_DOMAIN)
+set(DOMAINFLAG "")
+ENDIF(BITSET_DOMAIN)
+
 if(LONG_COSTS)
   SET(COST LONGLONG_COST)
 ELSE(LONG_COSTS)
@@ -54,21 +60,21 @@ IF(TOULBAR2)
 	    MESSAGE(STATUS "####DEFINE OPTION ==> COST= ${COST}  XMLFLAG= ${XMLFLAG} BOOST = ${boostflag} MPI = ${mpiflag} ##########################")
 	set_property(
 			TARGET toulbar2
-			PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} ${XMLFLAG} LINUX ${boostflag} ${mpiflag} ${WIDE_STRING} ${PROBABILITY}
+			PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} ${XMLFLAG} LINUX ${boostflag} ${mpiflag} ${WIDE_STRING} ${PROBABILITY} ${DOMAINFLAG}
 		    )
 ENDIF(TOULBAR2)
 
 IF(MENDELSOFT)
 	set_property(
 			TARGET mendelsoft
-			PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} MENDELSOFT LINUX ${WIDE_STRING} ${PROBABILITY}
+			PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} MENDELSOFT LINUX ${WIDE_STRING} ${PROBABILITY} ${DOMAINFLAG}
 		    )
 ENDIF(MENDELSOFT)
 
 IF(LIBTB2)
 	set_property(
 			TARGET tb2
-			PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} LINUX ${WIDE_STRING} ${PROBABILITY}
+			PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} LINUX ${WIDE_STRING} ${PROBABILITY} ${DOMAINFLAG}
 		    )
 ENDIF(LIBTB2)
 
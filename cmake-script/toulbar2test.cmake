@@ -15,14 +15,14 @@ LINK_DIRECTORIES( ${CMAKE_CURRENT_SOURCE_DIR}/${LIBRARY_OUTPUT_PATH})
 
 
         add_executable( toulbar2test ${toulbar2test_file})
-        TARGET_LINK_LIBRARIES( toulbar2test tb2 gmp)
+        TARGET_LINK_LIBRARIES( toulbar2test tb2 gmp ${CMAKE_THREAD_LIBS_INIT})
         add_dependencies(toulbar2test tb2)
         add_dependencies(toulbar2test gmp)
         install( TARGETS toulbar2test DESTINATION bin )
 
 	set_property(
 			TARGET toulbar2test
-			PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} LINUX ${WIDE_STRING} ${PROBABILITY}
+			PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} LINUX ${WIDE_STRING} ${PROBABILITY} ${DOMAINFLAG}
 		    )
 
 ENDIF(LIBTB2)
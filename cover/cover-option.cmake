@@ -51,6 +51,11 @@ SET (CELAR6-SUB0.wcsp
     "-O=CELAR6-SUB0.mcs.order -B=2 -j=1 -Z"
     "-O=CELAR6-SUB0.mcs.order -B=2 -j=1 -k=1 -Z"
     "-n -t -i"
+    "-portfolio=2"
+    "-portfolio=4 -A"
+    "-phbfs=2"
+    "-phbfs=3 -A"
+    "-hbfsinc"
     "-n -t -ub=160"
     "-n -ub=160"
     "-w"
@@ -104,6 +109,7 @@ SET (pedigree1.wcsp
     "-n=4"
     "-q: -e"
     "-t -n"
+    "-t -cow=3"
     "-ub=1000"
     "-ub=1000000"
     "-ub=10000000"
@@ -1,9 +1,9 @@
-SET(CPACK_PACKAGE_VERSION "1.0.0")
-SET(CPACK_NSIS_DISPLAY_NAME "toulbar2 1.0.0")
-SET(CPACK_NSIS_PACKAGE_NAME "toulbar2 1.0.0")
-SET(CPACK_PACKAGE_FILE_NAME "toulbar2-1.0.0-x86_64")
-SET(CPACK_PACKAGE_INSTALL_DIRECTORY "toulbar2 1.0.0")
-SET(CPACK_PACKAGE_INSTALL_REGISTRY_KEY "toulbar2 1.0.0")
-SET(CPACK_PACKAGE_VERSION_MAJOR "1")
-SET(CPACK_PACKAGE_VERSION_MINOR "0")
-SET(CPACK_PACKAGE_VERSION_PATCH "0")
+SET(CPACK_PACKAGE_VERSION "")
+SET(CPACK_NSIS_DISPLAY_NAME "toulbar2 ")
+SET(CPACK_NSIS_PACKAGE_NAME "toulbar2 ")
+SET(CPACK_PACKAGE_FILE_NAME "toulbar2--x86_64")
+SET(CPACK_PACKAGE_INSTALL_DIRECTORY "toulbar2 ")
+SET(CPACK_PACKAGE_INSTALL_REGISTRY_KEY "toulbar2 ")
+SET(CPACK_PACKAGE_VERSION_MAJOR "")
+SET(CPACK_PACKAGE_VERSION_MINOR "")
+SET(CPACK_PACKAGE_VERSION_PATCH "")
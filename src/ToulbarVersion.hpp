@@ -1,2 +1,2 @@
 // Cmake generated version
-#define Toulbar_VERSION "1.0.0-master-aab1312-tainted (1530783600)"
+#define Toulbar_VERSION "-master-8b888a9-tainted (1792237464)"
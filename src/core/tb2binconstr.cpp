@@ -6,6 +6,11 @@
 #include "tb2wcsp.hpp"
 #include "search/tb2clusters.hpp"
 
+#if defined(LONGLONG_COST) && defined(__GNUC__) && defined(__x86_64__)
+#define SIMD_MINCOST
+#include <immintrin.h>
+#endif
+
 /*
  * Constructors and misc.
  *
@@ -22,15 +27,41 @@ BinaryConstraint::BinaryConstraint(WCSP* wcsp, EnumeratedVariable* xx, Enumerate
     supportX = vector<Value>(sizeX, y->getInf());
     supportY = vector<Value>(sizeY, x->getInf());
 
-    costs = vector<StoreCost>(sizeX * sizeY, StoreCost(MIN_COST));
+    costs.setPaged(ToulBar2::costCheckpoint & 1);
+    Cost defaultCost = MIN_COST;
+    if (!costs.isPaged() && sparseTable(tab, defaultCost)) {
+        costs.assignSparse(sizeX * sizeY, defaultCost);
+        for (unsigned int a = 0; a < sizeX * sizeY; a++)
+            if (tab[a] != defaultCost)
+                costs[a] = tab[a];
+    } else {
+        costs.assign(sizeX * sizeY, MIN_COST);
 
-    for (unsigned int a = 0; a < x->getDomainInitSize(); a++)
-        for (unsigned int b = 0; b < y->getDomainInitSize(); b++)
-            costs[a * sizeY + b] = tab[a * sizeY + b];
+        for (unsigned int a = 0; a < x->getDomainInitSize(); a++)
+            for (unsigned int b = 0; b < y->getDomainInitSize(); b++)
+                costs[a * sizeY + b] = tab[a * sizeY + b];
+    }
 
     propagate();
 }
 
+/// \brief tells if a large cost table has few costs different from its most frequent cost (returned in \a defaultCost)
+bool BinaryConstraint::sparseTable(const vector<Cost>& tab, Cost& defaultCost)
+{
+    if ((Long)tab.size() < SPARSEBINARYSIZE)
+        return false;
+    unordered_map<Cost, size_t> counts;
+    size_t maxCount = 0;
+    for (size_t a = 0; a < tab.size(); a++) {
+        size_t count = ++counts[tab[a]];
+        if (count > maxCount) {
+            maxCount = count;
+            defaultCost = tab[a];
+        }
+    }
+    return (tab.size() - maxCount) * SPARSEBINARYRATIO <= tab.size();
+}
+
 BinaryConstraint::BinaryConstraint(WCSP* wcsp)
     : AbstractBinaryConstraint<EnumeratedVariable, EnumeratedVariable>(wcsp)
     , sizeX(0)
@@ -43,6 +74,7 @@ BinaryConstraint::BinaryConstraint(WCSP* wcsp)
     //    supportY = vector<Value>(maxdomainsize,0);
     linkX = new DLink<ConstraintLink>;
     linkY = new DLink<ConstraintLink>;
+    costs.setPaged(ToulBar2::costCheckpoint & 1);
 
     //    costs = vector<StoreCost>(maxdomainsize*maxdomainsize,StoreCost(MIN_COST,storeCost));
     //    for (unsigned int a = 0; a < maxdomainsize; a++)
@@ -119,6 +151,128 @@ void BinaryConstraint::extend(EnumeratedVariable* x, Value value, Cost cost, vec
     x->extend(value, cost);
 }
 
+/*
+ * Vectorized search of a minimum cost in a row (or a column) of a cost table
+ *
+ * Blocks of costs are compared all at once with the current minimum, a block being scanned value by value only when it contains a smaller cost,
+ * in order to return the same (first) minimum as the scalar loop, including its stop at the first cost lower than or equal to the bound.
+ */
+
+static inline Cost rowCost(const Cost* costs, ptrdiff_t stride, const Cost* deltas, const Cost* unaries, unsigned int i)
+{
+    Cost cost = costs[i * stride] - deltas[i];
+    if (unaries)
+        cost += unaries[i];
+    return cost;
+}
+
+// scans values from \a i to \a end, returning true if the bound is reached
+static inline bool scanMinCost(const Cost* costs, ptrdiff_t stride, const Cost* deltas, const Cost* unaries, unsigned int i, unsigned int end, Cost bound, Cost& minCost, unsigned int& pos)
+{
+    for (; i < end; i++) {
+        Cost cost = rowCost(costs, stride, deltas, unaries, i);
+        if (cost < minCost) {
+            minCost = cost;
+            pos = i;
+            if (minCost <= bound)
+                return true;
+        }
+    }
+    return false;
+}
+
+static unsigned int minCostIndexScalar(const Cost* costs, ptrdiff_t stride, const Cost* deltas, const Cost* unaries, unsigned int n, Cost bound, Cost& minCost)
+{
+    assert(n > 0);
+    unsigned int pos = 0;
+    minCost = rowCost(costs, stride, deltas, unaries, 0);
+    if (minCost > bound)
+        scanMinCost(costs, stride, deltas, unaries, 1, n, bound, minCost, pos);
+    return pos;
+}
+
+#ifdef SIMD_MINCOST
+__attribute__((target("avx2"))) static unsigned int minCostIndexAVX2(const Cost* costs, ptrdiff_t stride, const Cost* deltas, const Cost* unaries, unsigned int n, Cost bound, Cost& minCost)
+{
+    assert(n > 0);
+    unsigned int pos = 0;
+    minCost = rowCost(costs, stride, deltas, unaries, 0);
+    if (minCost <= bound)
+        return pos;
+    unsigned int i = 1;
+    __m256i vmin = _mm256_set1_epi64x(minCost);
+    const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+    for (; i + 4 <= n; i += 4) {
+        __m256i v;
+        if (stride == 1)
+            v = _mm256_loadu_si256((const __m256i*)(costs + i));
+        else
+            v = _mm256_i64gather_epi64((const long long*)(costs + i * stride), offsets, sizeof(Cost));
+        v = _mm256_sub_epi64(v, _mm256_loadu_si256((const __m256i*)(deltas + i)));
+        if (unaries)
+            v = _mm256_add_epi64(v, _mm256_loadu_si256((const __m256i*)(unaries + i)));
+        __m256i smaller = _mm256_cmpgt_epi64(vmin, v);
+        if (!_mm256_testz_si256(smaller, smaller)) {
+            if (scanMinCost(costs, stride, deltas, unaries, i, i + 4, bound, minCost, pos))
+                return pos;
+            vmin = _mm256_set1_epi64x(minCost);
+        }
+    }
+    scanMinCost(costs, stride, deltas, unaries, i, n, bound, minCost, pos);
+    return pos;
+}
+
+__attribute__((target("avx512f"))) static unsigned int minCostIndexAVX512(const Cost* costs, ptrdiff_t stride, const Cost* deltas, const Cost* unaries, unsigned int n, Cost bound, Cost& minCost)
+{
+    assert(n > 0);
+    unsigned int pos = 0;
+    minCost = rowCost(costs, stride, deltas, unaries, 0);
+    if (minCost <= bound)
+        return pos;
+    unsigned int i = 1;
+    __m512i vmin = _mm512_set1_epi64(minCost);
+    const __m512i offsets = _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride, 3 * stride, 2 * stride, stride, 0);
+    for (; i + 8 <= n; i += 8) {
+        __m512i v;
+        if (stride == 1)
+            v = _mm512_loadu_si512((const void*)(costs + i));
+        else
+            v = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF, offsets, (const void*)(costs + i * stride), sizeof(Cost));
+        v = _mm512_sub_epi64(v, _mm512_loadu_si512((const void*)(deltas + i)));
+        if (unaries)
+            v = _mm512_add_epi64(v, _mm512_loadu_si512((const void*)(unaries + i)));
+        if (_mm512_cmpgt_epi64_mask(vmin, v)) {
+            if (scanMinCost(costs, stride, deltas, unaries, i, i + 8, bound, minCost, pos))
+                return pos;
+            vmin = _mm512_set1_epi64(minCost);
+        }
+    }
+    scanMinCost(costs, stride, deltas, unaries, i, n, bound, minCost, pos);
+    return pos;
+}
+#endif
+
+typedef unsigned int (*MinCostIndexFunc)(const Cost* costs, ptrdiff_t stride, const Cost* deltas, const Cost* unaries, unsigned int n, Cost bound, Cost& minCost);
+
+static MinCostIndexFunc selectMinCostIndex()
+{
+#ifdef SIMD_MINCOST
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return minCostIndexAVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return minCostIndexAVX2;
+#endif
+    return minCostIndexScalar;
+}
+
+static const MinCostIndexFunc minCostIndexFunc = selectMinCostIndex();
+
+unsigned int BinaryConstraint::minCostIndex(const Cost* costs, ptrdiff_t stride, const Cost* deltas, const Cost* unaries, unsigned int n, Cost bound, Cost& minCost)
+{
+    return (*minCostIndexFunc)(costs, stride, deltas, unaries, n, bound, minCost);
+}
+
 void BinaryConstraint::permute(EnumeratedVariable* xin, Value a, Value b)
 {
     EnumeratedVariable* yin = y;
@@ -17,6 +17,8 @@ struct Functor_getCost {
     {
     }
     inline Cost operator()(EnumeratedVariable* xx, EnumeratedVariable* yy, Value vx, Value vy) const;
+    /// \brief gives the costs of \a vx with all initial values of y, their stride, the deltas of y, and the delta of \a vx
+    inline const Cost* row(Value vx, ptrdiff_t& stride, const Cost*& deltasY, Cost& deltaX) const;
 };
 struct Functor_getCostReverse {
     BinaryConstraint& obj;
@@ -25,6 +27,7 @@ struct Functor_getCostReverse {
     {
     }
     inline Cost operator()(EnumeratedVariable* xx, EnumeratedVariable* yy, Value vy, Value vx) const;
+    inline const Cost* row(Value vy, ptrdiff_t& stride, const Cost*& deltasX, Cost& deltaY) const;
 };
 
 class BinaryConstraint : public AbstractBinaryConstraint<EnumeratedVariable, EnumeratedVariable> {
@@ -33,7 +36,7 @@ protected:
     unsigned int sizeY;
     vector<StoreCost> deltaCostsX;
     vector<StoreCost> deltaCostsY;
-    vector<StoreCost> costs;
+    StoreCostTable costs;
 
     vector<Value> supportX;
     vector<Value> supportY;
@@ -50,6 +53,11 @@ protected:
     template <typename T>
     bool verify(T getCost, EnumeratedVariable* x, EnumeratedVariable* y);
 
+    template <typename T>
+    inline void findMinCost(T getCost, EnumeratedVariable* x, EnumeratedVariable* y, Value vx, bool unary, Value& minCostValue, Cost& minCost);
+
+    static bool sparseTable(const vector<Cost>& tab, Cost& defaultCost);
+
     // return true if unary support of x is broken
     bool project(EnumeratedVariable* x, Value value, Cost cost, vector<StoreCost>& deltaCostsX);
     void extend(EnumeratedVariable* x, Value value, Cost cost, vector<StoreCost>& deltaCostsX);
@@ -68,6 +76,11 @@ protected:
     void extendY(Value value, Cost cost) { extend(y, value, cost, deltaCostsY); }
 
 public:
+    /// \brief finds the first minimum of costs[i * stride] - deltas[i] (+ unaries[i] if not NULL) for i in [0, n), stopping at the first value lower than or equal to \a bound
+    /// \return the index of the minimum, its value being returned in \a minCost
+    /// \note uses AVX-512 or AVX2 instructions when available at runtime, with the same result as the scalar loop
+    static unsigned int minCostIndex(const Cost* costs, ptrdiff_t stride, const Cost* deltas, const Cost* unaries, unsigned int n, Cost bound, Cost& minCost);
+
     BinaryConstraint(WCSP* wcsp, EnumeratedVariable* xx, EnumeratedVariable* yy, vector<Cost>& tab);
 
     BinaryConstraint(WCSP* wcsp);
@@ -329,7 +342,7 @@ public:
         if (sizeY > supportY.size())
             supportY.resize(sizeY);
         if (sizeX * sizeY > costs.size())
-            costs.resize(sizeX * sizeY, StoreCost(MIN_COST));
+            costs.resize(sizeX * sizeY, MIN_COST);
         linkX->removed = true;
         linkY->removed = true;
         linkX->content.constr = this;
@@ -556,7 +569,8 @@ public:
     void print(ostream& os);
     void dump(ostream& os, bool original = true);
     Long size() const FINAL { return (Long)sizeX * sizeY; }
-    Long space() const FINAL { return (Long)sizeof(StoreCost) * sizeX * sizeY; }
+    Long space() const FINAL { return (costs.isSparse()) ? costs.space() : (Long)sizeof(StoreCost) * sizeX * sizeY; }
+    bool isSparse() const { return costs.isSparse(); } ///< \brief true if only the costs different from the most frequent one are stored
 
     friend struct Functor_getCost;
     friend struct Functor_getCostReverse;
@@ -574,6 +588,70 @@ inline Cost Functor_getCostReverse::operator()(EnumeratedVariable* yy, Enumerate
     assert(yy == obj.y);
     return obj.getCost(vx, vy);
 }
+inline const Cost* Functor_getCost::row(Value vx, ptrdiff_t& stride, const Cost*& deltasY, Cost& deltaX) const
+{
+    unsigned int ix = obj.x->toIndex(vx);
+    stride = 1;
+    deltasY = costData(obj.deltaCostsY);
+    deltaX = obj.deltaCostsX[ix];
+    return obj.costs.data() + (size_t)ix * obj.sizeY;
+}
+inline const Cost* Functor_getCostReverse::row(Value vy, ptrdiff_t& stride, const Cost*& deltasX, Cost& deltaY) const
+{
+    unsigned int iy = obj.y->toIndex(vy);
+    stride = obj.sizeY;
+    deltasX = costData(obj.deltaCostsX);
+    deltaY = obj.deltaCostsY[iy];
+    return obj.costs.data() + iy;
+}
+
+// finds the first minimum cost (with unary costs of y if \a unary is true) of \a vx over the domain of y, stopping at the first zero cost
+template <typename T>
+inline void BinaryConstraint::findMinCost(T getCost, EnumeratedVariable* x, EnumeratedVariable* y, Value vx, bool unary, Value& minCostValue, Cost& minCost)
+{
+    if (y->getDomainInitSize() == 2) {
+        // Boolean variable y: compares its (at most) two values directly
+        minCostValue = y->getInf();
+        minCost = getCost(x, y, vx, minCostValue);
+        if (unary)
+            minCost += y->getCost(minCostValue);
+        if (minCost > MIN_COST && y->unassigned()) {
+            Cost cost = getCost(x, y, vx, y->getSup());
+            if (unary)
+                cost += y->getCost(y->getSup());
+            if (GLB(&minCost, cost))
+                minCostValue = y->getSup();
+        }
+        return;
+    }
+    if (!costs.isSparse() && y->getDomainSize() == (unsigned int)(y->getSup() - y->getInf() + 1)) {
+        // no hole in the domain of y: vectorized scan of the row (or column) of vx
+        ptrdiff_t stride = 0;
+        const Cost* deltasY = NULL;
+        Cost bound = MIN_COST;
+        const Cost* row = getCost.row(vx, stride, deltasY, bound);
+        unsigned int first = y->toIndex(y->getInf());
+        if (unary)
+            bound += y->getDeltaCost();
+        unsigned int i = minCostIndex(row + first * stride, stride, deltasY + first, (unary) ? y->getCostData() + first : NULL, y->getDomainSize(), bound, minCost);
+        minCostValue = y->toValue(first + i);
+        minCost -= bound;
+        return;
+    }
+    minCostValue = y->getInf();
+    minCost = getCost(x, y, vx, minCostValue);
+    if (unary)
+        minCost += y->getCost(minCostValue);
+    EnumeratedVariable::iterator iterY = y->begin();
+    for (++iterY; minCost > MIN_COST && iterY != y->end(); ++iterY) {
+        Cost cost = getCost(x, y, vx, *iterY);
+        if (unary)
+            cost += y->getCost(*iterY);
+        if (GLB(&minCost, cost)) {
+            minCostValue = *iterY;
+        }
+    }
+}
 
 template <typename T>
 void BinaryConstraint::findSupport(T getCost, EnumeratedVariable* x, EnumeratedVariable* y,
@@ -588,15 +666,9 @@ void BinaryConstraint::findSupport(T getCost, EnumeratedVariable* x, EnumeratedV
         unsigned int xindex = x->toIndex(*iterX);
         Value support = supportX[xindex];
         if (y->cannotbe(support) || getCost(x, y, *iterX, support) > MIN_COST) {
-            Value minCostValue = y->getInf();
-            Cost minCost = getCost(x, y, *iterX, minCostValue);
-            EnumeratedVariable::iterator iterY = y->begin();
-            for (++iterY; minCost > MIN_COST && iterY != y->end(); ++iterY) {
-                Cost cost = getCost(x, y, *iterX, *iterY);
-                if (GLB(&minCost, cost)) {
-                    minCostValue = *iterY;
-                }
-            }
+            Value minCostValue;
+            Cost minCost;
+            findMinCost(getCost, x, y, *iterX, false, minCostValue, minCost);
             if (minCost > MIN_COST) {
                 supportBroken |= project(x, *iterX, minCost, deltaCostsX);
                 if (deconnected())
@@ -624,15 +696,9 @@ void BinaryConstraint::findFullSupport(T getCost, EnumeratedVariable* x, Enumera
         unsigned int xindex = x->toIndex(*iterX);
         Value support = supportX[xindex];
         if (y->cannotbe(support) || getCost(x, y, *iterX, support) + y->getCost(support) > MIN_COST) {
-            Value minCostValue = y->getInf();
-            Cost minCost = getCost(x, y, *iterX, minCostValue) + y->getCost(minCostValue);
-            EnumeratedVariable::iterator iterY = y->begin();
-            for (++iterY; minCost > MIN_COST && iterY != y->end(); ++iterY) {
-                Cost cost = getCost(x, y, *iterX, *iterY) + y->getCost(*iterY);
-                if (GLB(&minCost, cost)) {
-                    minCostValue = *iterY;
-                }
-            }
+            Value minCostValue;
+            Cost minCost;
+            findMinCost(getCost, x, y, *iterX, true, minCostValue, minCost);
             if (minCost > MIN_COST) {
                 // extend unary to binary
                 for (EnumeratedVariable::iterator iterY = y->begin(); iterY != y->end(); ++iterY) {
@@ -9,8 +9,53 @@
  * 
  */
 
+#ifdef BITSETDOMAIN
 Domain::Domain(Value inf, Value sup)
-    : BTList<Value>(&Store::storeDomain)
+    : initSize(sup - inf + 1)
+    , distanceToZero(inf)
+    , nbWords((initSize + WORD_BITS - 1) / WORD_BITS)
+    , bits(NULL)
+    , size(0)
+{
+    init(inf, sup);
+}
+
+Domain::Domain(Value* d, int dsize)
+    : initSize(max(d, dsize) - min(d, dsize) + 1)
+    , distanceToZero(min(d, dsize))
+    , nbWords((initSize + WORD_BITS - 1) / WORD_BITS)
+    , bits(NULL)
+    , size(0)
+{
+    assert(dsize >= 1);
+    assert(dsize <= MAX_DOMAIN_SIZE);
+    qsort(d, dsize, sizeof(Value), cmpValue);
+    init(d[0], d[dsize - 1]);
+    std::fill(bits, bits + nbWords, 0);
+    for (int i = 0; i < dsize; i++)
+        bits[toIndex(d[i]) / WORD_BITS] |= (BitWord)1 << (toIndex(d[i]) % WORD_BITS);
+    int n = 0;
+    for (unsigned int w = 0; w < nbWords; w++)
+        n += __builtin_popcountll(bits[w]);
+    size = n;
+}
+
+void Domain::init(Value inf, Value sup)
+{
+    assert(sup - inf + 1 >= 1);
+    assert(sup - inf + 1 <= MAX_DOMAIN_SIZE);
+#if defined(WCSPFORMATONLY) && !defined(NUMBERJACK)
+    assert(distanceToZero == 0);
+#endif
+    bits = new BitWord[nbWords];
+    std::fill(bits, bits + nbWords, ~(BitWord)0);
+    if (initSize % WORD_BITS)
+        bits[nbWords - 1] = ~(BitWord)0 >> (WORD_BITS - initSize % WORD_BITS); // no value after the last one
+    size = initSize;
+}
+#else
+Domain::Domain(Value inf, Value sup)
+    : BTList<Value>(&Store::trail)
     , initSize(sup - inf + 1)
     , distanceToZero(inf)
 {
@@ -18,7 +63,7 @@ Domain::Domain(Value inf, Value sup)
 }
 
 Domain::Domain(Value* d, int dsize)
-    : BTList<Value>(&Store::storeDomain)
+    : BTList<Value>(&Store::trail)
     , initSize(max(d, dsize) - min(d, dsize) + 1)
     , distanceToZero(min(d, dsize))
 {
@@ -48,6 +93,7 @@ void Domain::init(Value inf, Value sup)
         push_back(&all[idx], false);
     }
 }
+#endif
 
 int cmpValue(const void* v1, const void* v2)
 {
@@ -1,6 +1,10 @@
 /** \file tb2domain.hpp
  *  \brief Storable enumerated domain.
- * 
+ *
+ *  By default, a domain is a backtrackable list of all its initial values (see BTList), giving constant-time removals and iterations over the remaining values.
+ *  When compiled with BITSETDOMAIN (cmake -DBITSET_DOMAIN=ON), a domain is a bitset of its initial values instead, with one trail entry per modified word,
+ *  domain size maintained by popcount, next / previous value found by counting trailing / leading zeros, and bound changes done word by word.
+ *  Both representations share the same interface and iterate over values in increasing order.
  */
 
 #ifndef TB2DOMAIN_HPP_
@@ -10,6 +14,199 @@
 
 extern int cmpValue(const void* v1, const void* v2);
 
+#ifdef BITSETDOMAIN
+class Domain {
+    static const int WORD_BITS = 8 * sizeof(BitWord);
+
+    const unsigned int initSize;
+    const Value distanceToZero;
+    const unsigned int nbWords;
+    BitWord* bits; // bit idx is set if value toValue(idx) is in the domain
+    StoreInt size;
+
+    void init(Value inf, Value sup);
+
+    // make it private because we don't want copy nor assignment
+    Domain(const Domain& s);
+    Domain& operator=(const Domain& s);
+
+    void trail(unsigned int w) { Store::trail.store(&bits[w]); }
+
+    // removes the values of word w given by mask
+    void eraseWord(unsigned int w, BitWord mask)
+    {
+        mask &= bits[w];
+        if (mask) {
+            trail(w);
+            bits[w] &= ~mask;
+            size = size - __builtin_popcountll(mask);
+        }
+    }
+
+    // returns the index of the first value after idx (-1 if none)
+    int next(int idx) const
+    {
+        assert(idx >= -1);
+        unsigned int i = idx + 1;
+        unsigned int w = i / WORD_BITS;
+        if (w >= nbWords)
+            return -1;
+        BitWord m = bits[w] & (~(BitWord)0 << (i % WORD_BITS));
+        if (m)
+            return w * WORD_BITS + __builtin_ctzll(m);
+        return nextWord(w + 1);
+    }
+    int nextWord(unsigned int w) const
+    {
+        for (; w < nbWords; w++)
+            if (bits[w])
+                return w * WORD_BITS + __builtin_ctzll(bits[w]);
+        return -1;
+    }
+
+    // returns the index of the last value before idx (-1 if none)
+    int prev(int idx) const
+    {
+        if (idx <= 0)
+            return -1;
+        unsigned int i = idx - 1;
+        unsigned int w = i / WORD_BITS;
+        BitWord m = bits[w] & (~(BitWord)0 >> (WORD_BITS - 1 - i % WORD_BITS));
+        if (m)
+            return w * WORD_BITS + WORD_BITS - 1 - __builtin_clzll(m);
+        return prevWord(w);
+    }
+    int prevWord(unsigned int w) const
+    {
+        while (w > 0)
+            if (bits[--w])
+                return w * WORD_BITS + WORD_BITS - 1 - __builtin_clzll(bits[w]);
+        return -1;
+    }
+
+public:
+    class iterator {
+        const Domain* dom;
+        int idx; // -1 at the end
+
+    public:
+        iterator()
+            : dom(NULL)
+            , idx(-1)
+        {
+        }
+        iterator(const Domain* d, int i)
+            : dom(d)
+            , idx(i)
+        {
+        }
+
+        Value operator*() const
+        {
+            assert(idx >= 0);
+            return dom->toValue(idx);
+        }
+
+        iterator& operator++()
+        { // Prefix form
+            if (idx >= 0)
+                idx = dom->next(idx);
+            return *this;
+        }
+
+        iterator& operator--()
+        { // Prefix form
+            if (idx >= 0)
+                idx = dom->prev(idx);
+            return *this;
+        }
+
+        // To see if you're at the end:
+        bool operator==(const iterator& iter) const { return idx == iter.idx; }
+        bool operator!=(const iterator& iter) const { return idx != iter.idx; }
+    };
+
+    Domain(Value inf, Value sup);
+
+    Domain(Value* d, int dsize);
+
+    ~Domain()
+    {
+        delete[] bits;
+    }
+
+    unsigned int getInitSize() const { return initSize; }
+    unsigned int toIndex(Value v) const { return v - distanceToZero; }
+    Value toValue(int idx) const { return idx + distanceToZero; }
+    unsigned int toCurrentIndex(Value v)
+    {
+        assert(canbe(v));
+        unsigned int idx = toIndex(v);
+        unsigned int pos = 0;
+        for (unsigned int w = 0; w < idx / WORD_BITS; w++)
+            pos += __builtin_popcountll(bits[w]);
+        if (idx % WORD_BITS)
+            pos += __builtin_popcountll(bits[idx / WORD_BITS] & (~(BitWord)0 >> (WORD_BITS - idx % WORD_BITS)));
+        return pos;
+    }
+
+    int getSize() const { return size; }
+    bool empty() const { return size == 0; }
+
+    bool canbe(Value v) const { return (bits[toIndex(v) / WORD_BITS] >> (toIndex(v) % WORD_BITS)) & 1; }
+    bool cannotbe(Value v) const { return !canbe(v); }
+
+    void erase(Value v)
+    {
+        assert(canbe(v));
+        eraseWord(toIndex(v) / WORD_BITS, (BitWord)1 << (toIndex(v) % WORD_BITS));
+    }
+
+    // removes all values lower than v
+    Value increase(Value v)
+    {
+        unsigned int idx = toIndex(v);
+        for (unsigned int w = 0; w < idx / WORD_BITS; w++)
+            eraseWord(w, ~(BitWord)0);
+        if (idx % WORD_BITS)
+            eraseWord(idx / WORD_BITS, ~(BitWord)0 >> (WORD_BITS - idx % WORD_BITS));
+        assert(canbe(*lower_bound(v)));
+        return *lower_bound(v);
+    }
+    // removes all values greater than v
+    Value decrease(Value v)
+    {
+        unsigned int idx = toIndex(v) + 1;
+        if (idx % WORD_BITS)
+            eraseWord(idx / WORD_BITS, ~(BitWord)0 << (idx % WORD_BITS));
+        for (unsigned int w = (idx + WORD_BITS - 1) / WORD_BITS; w < nbWords; w++)
+            eraseWord(w, ~(BitWord)0);
+        assert(canbe(*upper_bound(v)));
+        return *upper_bound(v);
+    }
+
+    iterator begin() const { return iterator(this, next(-1)); }
+    iterator end() const { return iterator(); }
+    iterator rbegin() const { return iterator(this, prev(initSize)); }
+    iterator rend() const { return end(); }
+
+    //Finds the first available element whose value is greater or equal to v
+    iterator lower_bound(Value v) const
+    {
+        assert(toIndex(v) >= 0 && toIndex(v) < initSize);
+        return iterator(this, (canbe(v)) ? (int)toIndex(v) : next(toIndex(v)));
+    }
+
+    //Finds the first available element whose value is lower or equal to v
+    iterator upper_bound(Value v) const
+    {
+        assert(toIndex(v) >= 0 && toIndex(v) < initSize);
+        return iterator(this, (canbe(v)) ? (int)toIndex(v) : prev(toIndex(v)));
+    }
+
+    friend ostream& operator<<(ostream& os, Domain& l);
+};
+#else
 class Domain : public BTList<Value> {
     const unsigned int initSize;
     const Value distanceToZero;
@@ -99,6 +296,7 @@ public:
 
     friend ostream& operator<<(ostream& os, Domain& l);
 };
+#endif
 
 #endif /*TB2DOMAIN_HPP_*/
 
@@ -199,11 +199,17 @@ void EnumeratedVariable::findSupport()
     if (cannotbe(support) || getCost(support) > MIN_COST) {
         Value newSupport = getInf();
         Cost minCost = getCost(newSupport);
-        iterator iter = begin();
-        for (++iter; minCost > MIN_COST && iter != end(); ++iter) {
-            Cost cost = getCost(*iter);
-            if (GLB(&minCost, cost)) {
-                newSupport = *iter;
+        if (getDomainInitSize() == 2) {
+            // Boolean variable: its domain is {inf, sup} if unassigned, no need to iterate
+            if (unassigned() && minCost > MIN_COST && GLB(&minCost, getCost(sup)))
+                newSupport = sup;
+        } else {
+            iterator iter = begin();
+            for (++iter; minCost > MIN_COST && iter != end(); ++iter) {
+                Cost cost = getCost(*iter);
+                if (GLB(&minCost, cost)) {
+                    newSupport = *iter;
+                }
             }
         }
         if (minCost > MIN_COST) {
@@ -422,7 +428,113 @@ void EnumeratedVariable::propagateEAC()
     }
 }
 
-void EnumeratedVariable::propagateDEE(Value a, Value b, bool dee)
+/*
+ * Dense copies of the binary cost functions of a variable x used by all-pairs dead-end elimination:
+ * for each value a of x, the row of costs c(a,t) over the current values t of the other variable,
+ * its maximum, and the same row with MAX_COST for the pairs (a,t) that cannot extend below the upper bound.
+ * The maximum difference c(a,t) - c(b,t) of BinaryConstraint::getMaxCost is then a branch-free loop over two rows.
+ * Each table is built the first time one of its value pairs is checked, and rebuilt if the lower bound has changed.
+ */
+class EnumeratedVariable::DEETables {
+    struct Table {
+        bool built;
+        Cost lb; // lower bound used to mask the rows
+        unsigned int size; // number of current values of the other variable
+        vector<Cost> costs; // cost of (a,t) at index toIndex(a) * size + t
+        vector<Cost> masked; // same cost or MAX_COST if (a,t) is forbidden by the upper bound
+        vector<Cost> maxcost; // maximum cost of each row
+    };
+
+    EnumeratedVariable* x;
+    vector<Table> tables;
+    std::unordered_map<Constraint*, unsigned int> slot; // position of each binary cost function in tables
+
+    void build(Table& tab, BinaryConstraint* ctr)
+    {
+        EnumeratedVariable* y = (EnumeratedVariable*)ctr->getVarDiffFrom(x);
+        Cost lb = x->wcsp->getLb();
+        Cost ub = x->wcsp->getUb();
+        tab.size = y->getDomainSize();
+        tab.costs.resize(x->getDomainInitSize() * tab.size);
+        tab.masked.resize(x->getDomainInitSize() * tab.size);
+        tab.maxcost.resize(x->getDomainInitSize());
+        vector<Cost> ucosty;
+        for (iterator itt = y->begin(); itt != y->end(); ++itt)
+            ucosty.push_back(y->getCost(*itt));
+        for (iterator ita = x->begin(); ita != x->end(); ++ita) {
+            unsigned int ia = x->toIndex(*ita);
+            Cost ucosta = x->getCost(*ita);
+            Cost* c = &tab.costs[ia * tab.size];
+            Cost* m = &tab.masked[ia * tab.size];
+            Cost maxcost = MIN_COST;
+            unsigned int t = 0;
+            for (iterator itt = y->begin(); itt != y->end(); ++itt, ++t) {
+                Cost cost = ctr->getCost(x, y, *ita, *itt);
+                c[t] = cost;
+                m[t] = (CUT(ucosta + cost + ucosty[t] + lb, ub)) ? MAX_COST : cost;
+                if (cost > maxcost)
+                    maxcost = cost;
+            }
+            tab.maxcost[ia] = maxcost;
+        }
+        tab.lb = lb;
+        tab.built = true;
+    }
+
+public:
+    DEETables(EnumeratedVariable* var)
+        : x(var)
+    {
+        for (ConstraintList::iterator iter = x->getConstrs()->begin(); iter != x->getConstrs()->end(); ++iter) {
+            if ((*iter).constr->isBinary()) {
+                slot[(*iter).constr] = tables.size();
+                tables.push_back(Table());
+                tables.back().built = false;
+            }
+        }
+    }
+
+    /// \brief same as Constraint::getMaxCost
+    pair<pair<Cost, Cost>, pair<Cost, Cost> > getMaxCost(const ConstraintLink& link, Value a, Value b)
+    {
+        std::unordered_map<Constraint*, unsigned int>::iterator it = slot.find(link.constr);
+        if (it == slot.end())
+            return link.constr->getMaxCost(link.scopeIndex, a, b);
+        Table& tab = tables[it->second];
+        if (!tab.built || tab.lb != x->wcsp->getLb())
+            build(tab, (BinaryConstraint*)link.constr);
+        const Cost* ca = &tab.costs[x->toIndex(a) * tab.size];
+        const Cost* cb = &tab.costs[x->toIndex(b) * tab.size];
+        const Cost* ma = &tab.masked[x->toIndex(a) * tab.size];
+        const Cost* mb = &tab.masked[x->toIndex(b) * tab.size];
+        Cost diffcosta = MIN_COST;
+        Cost diffcostb = MIN_COST;
+        for (unsigned int t = 0; t < tab.size; t++) {
+            diffcosta = max(diffcosta, ca[t] - mb[t]);
+            diffcostb = max(diffcostb, cb[t] - ma[t]);
+        }
+        return make_pair(make_pair(tab.maxcost[x->toIndex(a)], diffcosta), make_pair(tab.maxcost[x->toIndex(b)], diffcostb));
+    }
+};
+
+void EnumeratedVariable::propagateAllDEE()
+{
+    DEETables tables(this);
+    for (iterator itera = begin(); itera != end(); ++itera) {
+        for (iterator iterb = lower_bound(*itera + 1); iterb != end(); ++iterb) {
+            assert(canbe(*itera));
+            assert(canbe(*iterb));
+            assert(*itera != *iterb);
+            propagateDEE(*itera, *iterb, false, &tables);
+            if (assigned())
+                return;
+            if (cannotbe(*itera))
+                break;
+        }
+    }
+}
+
+void EnumeratedVariable::propagateDEE(Value a, Value b, bool dee, DEETables* tables)
 {
     //cout << "check DEE for " << *this << " " << a << " -> " << b << " " << dee << endl;
     if (a == b)
@@ -437,7 +549,7 @@ void EnumeratedVariable::propagateDEE(Value a, Value b, bool dee)
     ConstraintLink residue = ((dee) ? DEE : DEE2[a * getDomainInitSize() + b]);
     ConstraintLink residue2 = ((dee) ? DEE : DEE2[b * getDomainInitSize() + a]);
     if (costa <= costb && residue.constr && residue.constr->connected() && residue.scopeIndex < residue.constr->arity() && residue.constr->getVar(residue.scopeIndex) == this) {
-        pair<pair<Cost, Cost>, pair<Cost, Cost> > costs = residue.constr->getMaxCost(residue.scopeIndex, a, b);
+        pair<pair<Cost, Cost>, pair<Cost, Cost> > costs = (tables) ? tables->getMaxCost(residue, a, b) : residue.constr->getMaxCost(residue.scopeIndex, a, b);
         if (totalmaxcosta <= getMaxCost())
             totalmaxcosta += costs.first.first;
         if (totalmaxcostb <= getMaxCost())
@@ -450,7 +562,7 @@ void EnumeratedVariable::propagateDEE(Value a, Value b, bool dee)
             return;
     }
     if (costb <= costa && residue2.constr && (residue2.constr != residue.constr || costa > costb) && residue2.constr->connected() && residue2.scopeIndex < residue2.constr->arity() && residue2.constr->getVar(residue2.scopeIndex) == this) {
-        pair<pair<Cost, Cost>, pair<Cost, Cost> > costs = residue2.constr->getMaxCost(residue2.scopeIndex, a, b);
+        pair<pair<Cost, Cost>, pair<Cost, Cost> > costs = (tables) ? tables->getMaxCost(residue2, a, b) : residue2.constr->getMaxCost(residue2.scopeIndex, a, b);
         if (totalmaxcosta <= getMaxCost())
             totalmaxcosta += costs.first.first;
         if (totalmaxcostb <= getMaxCost())
@@ -467,7 +579,7 @@ void EnumeratedVariable::propagateDEE(Value a, Value b, bool dee)
             continue;
         if (costb <= costa && residue2.constr == (*iter).constr && residue2.scopeIndex == (*iter).scopeIndex)
             continue;
-        pair<pair<Cost, Cost>, pair<Cost, Cost> > costs = (*iter).constr->getMaxCost((*iter).scopeIndex, a, b);
+        pair<pair<Cost, Cost>, pair<Cost, Cost> > costs = (tables) ? tables->getMaxCost(*iter, a, b) : (*iter).constr->getMaxCost((*iter).scopeIndex, a, b);
         if (costs.second.second > costa) {
             if (dee) {
                 if (costa == costb)
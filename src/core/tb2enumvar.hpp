@@ -90,6 +90,10 @@ public:
     Cost getBinaryCost(ConstraintLink c, Value myvalue, Value itsvalue);
     Cost getBinaryCost(BinaryConstraint* c, Value myvalue, Value itsvalue);
 
+    /// \brief unary costs of all initial values, to be decreased by getDeltaCost() (see BinaryConstraint::findFullSupport)
+    const Cost* getCostData() const { return costData(costs); }
+    Cost getDeltaCost() const { return deltaCost; }
+
     Cost getInfCost() const FINAL { return costs[toIndex(getInf())] - deltaCost; }
     Cost getSupCost() const FINAL { return costs[toIndex(getSup())] - deltaCost; }
     void projectInfCost(Cost cost);
@@ -119,7 +123,9 @@ public:
     bool elimVar(TernaryConstraint* xyz);
 
     void queueDEE();
-    void propagateDEE(Value a, Value b, bool dee = true);
+    class DEETables; ///< \brief dense copies of the binary cost functions of a variable, built once for all its value pairs (see propagateAllDEE)
+    void propagateDEE(Value a, Value b, bool dee = true, DEETables* tables = NULL);
+    void propagateAllDEE(); ///< \brief checks dominance between all pairs of values (generalized dead-end elimination)
     bool verifyDEE(Value a, Value b);
     bool verifyDEE();
 
@@ -25,7 +25,7 @@ NaryConstraint::NaryConstraint(WCSP* wcsp, EnumeratedVariable** scope_in, int ar
     if (default_cost > Top)
         default_cost = Top;
 
-    pf = new TUPLES;
+    pf = newTupleStore();
     if (nbtuples != 0 && expandtodo(min(nbtuples, getDomainSizeProduct())))
         expand();
 
@@ -41,7 +41,17 @@ NaryConstraint::NaryConstraint(WCSP* wcsp)
     , nonassigned(0)
     , filters(NULL)
 {
-    pf = new TUPLES;
+    pf = newTupleStore();
+}
+
+TupleStore* NaryConstraint::newTupleStore(int xindex)
+{
+    vector<unsigned int> domainSizes;
+    for (int i = 0; i < arity_; i++) {
+        int j = ((i == xindex) ? (arity_ - 1) : ((i == arity_ - 1 && xindex >= 0) ? xindex : i));
+        domainSizes.push_back(((EnumeratedVariable*)getVar(j))->getDomainInitSize());
+    }
+    return new TupleStore(domainSizes);
 }
 
 NaryConstraint::~NaryConstraint()
@@ -152,8 +162,10 @@ void NaryConstraint::expand()
     }
     costSize = sz;
     std::fill(costs, costs + sz, default_cost);
-    for (TUPLES::iterator it = pf->begin(); it != pf->end(); ++it) {
-        costs[getCostsIndex(it->first)] = it->second;
+    String t;
+    for (TupleStore::iterator it = pf->begin(); it != pf->end(); ++it) {
+        it.tuple(t);
+        costs[getCostsIndex(t)] = it.cost();
     }
     delete pf;
     pf = NULL;
@@ -197,10 +209,9 @@ Cost NaryConstraint::eval(const String& tin, EnumeratedVariable** scope_in)
 Cost NaryConstraint::eval(const String& s)
 {
     if (pf) {
-        TUPLES& f = *pf;
-        TUPLES::iterator it = f.find(s);
-        if (it != f.end())
-            return it->second;
+        Cost* c = pf->find(s);
+        if (c)
+            return *c;
         else
             return default_cost;
     } else
@@ -212,7 +223,7 @@ void NaryConstraint::keepAllowedTuples(Cost df)
 {
     assert(CUT(wcsp->getUb(), df));
     if (pf) {
-        TUPLES* pfnew = new TUPLES;
+        TupleStore* pfnew = newTupleStore();
 
         String t;
         Cost c;
@@ -271,10 +282,10 @@ bool NaryConstraint::next(String& t, Cost& c)
     bool ok = false;
     if (pf) {
         while (!ok && (tuple_it != pf->end())) {
-            t = tuple_it->first;
-            c = tuple_it->second;
+            tuple_it.tuple(t);
+            c = tuple_it.cost();
             ok = (c != default_cost) && consistent(t);
-            tuple_it++;
+            ++tuple_it;
         }
     } else {
         while (!ok && nextlex(t, c)) {
@@ -763,10 +774,10 @@ void NaryConstraint::setInfiniteCost(Cost ub)
 {
     Cost mult_ub = ((ub < (MAX_COST / MEDIUM_COST)) ? (max(LARGE_COST, ub * MEDIUM_COST)) : ub);
     if (pf) {
-        for (TUPLES::iterator it = pf->begin(); it != pf->end(); ++it) {
-            Cost c = it->second;
+        for (TupleStore::iterator it = pf->begin(); it != pf->end(); ++it) {
+            Cost c = it.cost();
             if (CUT(c, ub))
-                it->second = mult_ub;
+                it.cost() = mult_ub;
         }
     } else {
         for (ptrdiff_t idx = 0; idx < costSize; idx++) {
@@ -917,13 +928,13 @@ void NaryConstraint::project(EnumeratedVariable* x)
         String t, tnext, tproj;
         Cost c;
         Value val;
-        TUPLES fproj;
-        TUPLES::iterator it;
+        TupleStore* fproj = newTupleStore(xindex);
+        TupleStore::iterator it;
         // First part of the projection: complexity O(|f|) we swap positions between the projected variable and the last variable
         while (!pf->empty()) {
             it = pf->begin();
-            t = it->first;
-            c = it->second;
+            it.tuple(t);
+            c = it.cost();
             assert(x->getDegree() == 1);
             val = x->toValue(t[xindex] - CHAR_FIRST);
             c += ((x->canbe(val)) ? (x->getCost(val)) : Top);
@@ -933,19 +944,21 @@ void NaryConstraint::project(EnumeratedVariable* x)
             Char a = tswap[arity_ - 1];
             tswap[arity_ - 1] = tswap[xindex];
             tswap[xindex] = a;
-            fproj[tswap] = c;
+            (*fproj)[tswap] = c;
             pf->erase(it);
         }
+        delete pf;
+        pf = newTupleStore(xindex); // for tuples of arity - 1 with x replaced by the last variable
 
         // Second part of the projection: complexity O(|f|) as the projected variable is in the last position,
         // it is sufficient to look for tuples with the same arity-1 prefix. If there are less than d (domain of
         // the projected variable) tuples, we have also to perform the minimum with default_cost
         // this is only true when the tuples are LEXICOGRAPHICALY ordered
         set<Value> markValue;
-        it = fproj.begin();
-        if (it != fproj.end()) {
-            t = it->first;
-            c = it->second;
+        it = fproj->begin();
+        if (it != fproj->end()) {
+            it.tuple(t);
+            c = it.cost();
             val = x->toValue(t[arity_ - 1] - CHAR_FIRST);
             bool end = false;
             unsigned int ntuples = ((x->canbe(val)) ? 1 : 0);
@@ -953,14 +966,14 @@ void NaryConstraint::project(EnumeratedVariable* x)
             markValue.insert(val);
 
             while (!end) {
-                it++;
-                end = (it == fproj.end());
+                ++it;
+                end = (it == fproj->end());
                 bool sameprefix = false;
 
                 Cost cnext = MAX_COST;
                 if (!end) {
-                    tnext = it->first;
-                    cnext = it->second;
+                    it.tuple(tnext);
+                    cnext = it.cost();
                     sameprefix = (t.compare(0, arity_ - 1, tnext, 0, arity_ - 1) == 0);
                     //cout << "<" << t << "," << c << ">   <" << tnext << "," << cnext << ">       : " << t.compare(0,arity_-1,tnext,0,arity_-1) << endl;
                 }
@@ -997,6 +1010,7 @@ void NaryConstraint::project(EnumeratedVariable* x)
                 }
             }
         }
+        delete fproj;
 
     } else {
         ptrdiff_t sz = costSize / x->getDomainInitSize();
@@ -1051,8 +1065,8 @@ void NaryConstraint::project(EnumeratedVariable* x)
     assert(negcost <= 0);
     if (negcost < 0) {
         if (pf) {
-            for (TUPLES::iterator it = pf->begin(); it != pf->end(); ++it) {
-                (*pf)[(*it).first] = (*it).second - negcost;
+            for (TupleStore::iterator it = pf->begin(); it != pf->end(); ++it) {
+                it.cost() -= negcost;
             }
         } else {
             for (ptrdiff_t idx = 0; idx < costSize; idx++) {
@@ -1275,13 +1289,13 @@ double NaryConstraint::computeTightness()
     double sum = 0;
     Cost* costs_ = new Cost[size()];
     if (pf) {
-        TUPLES::iterator it = pf->begin();
+        TupleStore::iterator it = pf->begin();
         while (it != pf->end()) {
-            Cost c = it->second;
+            Cost c = it.cost();
             sum += to_double(min(wcsp->getUb(), c));
             costs_[count] = min(wcsp->getUb(), c);
             count++;
-            it++;
+            ++it;
         }
     } else {
         for (ptrdiff_t idx = 0; idx < costSize; idx++) {
@@ -1351,11 +1365,12 @@ void NaryConstraint::print(ostream& os)
     if (ToulBar2::verbose >= 4) {
         if (pf) {
             os << "tuples: {";
-            TUPLES::iterator it = pf->begin();
+            String t;
+            TupleStore::iterator it = pf->begin();
             while (it != pf->end()) {
-                String t = it->first;
-                Cost c = it->second;
-                it++;
+                it.tuple(t);
+                Cost c = it.cost();
+                ++it;
                 os << "<";
                 for (unsigned int i = 0; i < t.size(); i++) {
                     os << t[i] - CHAR_FIRST;
@@ -1385,11 +1400,12 @@ void NaryConstraint::dump(ostream& os, bool original)
             os << " " << scope[i]->wcspIndex;
         os << " " << default_cost << " " << size() << endl;
         if (pf) {
-            TUPLES::iterator it = pf->begin();
+            String t;
+            TupleStore::iterator it = pf->begin();
             while (it != pf->end()) {
-                String t = it->first;
-                Cost c = it->second;
-                it++;
+                it.tuple(t);
+                Cost c = it.cost();
+                ++it;
                 for (unsigned int i = 0; i < t.size(); i++) {
                     os << scope[i]->toValue(t[i] - CHAR_FIRST) << " ";
                 }
@@ -5,18 +5,21 @@
 #include "tb2ternaryconstr.hpp"
 #include "tb2enumvar.hpp"
 #include "tb2wcsp.hpp"
+#include "tb2tuples.hpp"
 
 class NaryConstraint : public AbstractNaryConstraint {
-    typedef map<String, Cost> TUPLES;
-    TUPLES* pf;
+    typedef map<String, Cost> TUPLES; // only used for binary projections
+    TupleStore* pf;
     Cost* costs;
     ptrdiff_t costSize;
-    Cost default_cost; // default cost returned when tuple t is not found in TUPLES (used by function eval(t))
+    Cost default_cost; // default cost returned when tuple t is not found in pf (used by function eval(t))
     StoreInt nonassigned; // nonassigned variables during search, must be backtrackable (StoreInt)!
     ConstraintSet* filters;
-    TUPLES::iterator tuple_it;
+    TupleStore::iterator tuple_it;
     vector<Long> conflictWeights; // used by weighted degree heuristics
 
+    TupleStore* newTupleStore(int xindex = -1); // empty tuple store for the current scope (with x at xindex swapped with the last variable if xindex >= 0)
+
 public:
     NaryConstraint(WCSP* wcsp, EnumeratedVariable** scope_in, int arity_in, Cost defval, Long nbtuples = 0);
     NaryConstraint(WCSP* wcsp);
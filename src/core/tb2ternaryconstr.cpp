@@ -86,7 +86,8 @@ TernaryConstraint::TernaryConstraint(WCSP* wcsp,
         }
         //    	costs.free_all();
     } else {
-        costs = vector<StoreCost>(sizeX * sizeY * sizeZ, StoreCost(MIN_COST));
+        costs.setPaged(ToulBar2::costCheckpoint & 2);
+        costs.assign(sizeX * sizeY * sizeZ, MIN_COST);
         for (unsigned int a = 0; a < x->getDomainInitSize(); a++) {
             for (unsigned int b = 0; b < y->getDomainInitSize(); b++) {
                 for (unsigned int c = 0; c < z->getDomainInitSize(); c++) {
@@ -202,6 +203,7 @@ TernaryConstraint::TernaryConstraint(WCSP* wcsp)
     linkX = new DLink<ConstraintLink>;
     linkY = new DLink<ConstraintLink>;
     linkZ = new DLink<ConstraintLink>;
+    costs.setPaged(ToulBar2::costCheckpoint & 2);
 
     //    costs = vector<StoreCost>(maxdom*maxdom*maxdom,StoreCost(MIN_COST,storeCost));
     //    for (unsigned int a = 0; a < maxdom; a++)
@@ -17,6 +17,8 @@ struct Functor_getCostXYZ {
     {
     }
     inline Cost operator()(EnumeratedVariable* xx, EnumeratedVariable* yy, EnumeratedVariable* zz, Value vx, Value vy, Value vz) const;
+    /// \brief gives the costs of (\a vx, \a vy) with all initial values of z, their stride, the deltas of z, and the sum of the deltas of \a vx and \a vy (needs a cost table)
+    inline const Cost* row(Value vx, Value vy, ptrdiff_t& stride, const Cost*& deltasLast, Cost& delta) const;
 };
 struct Functor_getCostXZY {
     TernaryConstraint& obj;
@@ -33,6 +35,7 @@ struct Functor_getCostYXZ {
     {
     }
     inline Cost operator()(EnumeratedVariable* xx, EnumeratedVariable* yy, EnumeratedVariable* zz, Value vx, Value vy, Value vz) const;
+    inline const Cost* row(Value vy, Value vx, ptrdiff_t& stride, const Cost*& deltasLast, Cost& delta) const;
 };
 struct Functor_getCostYZX {
     TernaryConstraint& obj;
@@ -49,6 +52,7 @@ struct Functor_getCostZXY {
     {
     }
     inline Cost operator()(EnumeratedVariable* xx, EnumeratedVariable* yy, EnumeratedVariable* zz, Value vx, Value vy, Value vz) const;
+    inline const Cost* row(Value vz, Value vx, ptrdiff_t& stride, const Cost*& deltasLast, Cost& delta) const;
 };
 struct Functor_getCostZYX {
     TernaryConstraint& obj;
@@ -211,7 +215,7 @@ protected:
     unsigned int sizeX;
     unsigned int sizeY;
     unsigned int sizeZ;
-    vector<StoreCost> costs;
+    StoreCostTable costs;
     vector<StoreCost> deltaCostsX;
     vector<StoreCost> deltaCostsY;
     vector<StoreCost> deltaCostsZ;
@@ -1062,7 +1066,7 @@ public:
         if (sizeZ > supportZ.size())
             supportZ.resize(sizeZ);
         if (sizeX * sizeY * sizeZ > costs.size())
-            costs.resize(sizeX * sizeY * sizeZ, StoreCost(MIN_COST));
+            costs.resize(sizeX * sizeY * sizeZ, MIN_COST);
         linkX->removed = true;
         linkY->removed = true;
         linkZ->removed = true;
@@ -1160,6 +1164,34 @@ inline Cost Functor_getCostZYX::operator()(EnumeratedVariable* zz, EnumeratedVar
     return obj.getCost(vx, vy, vz);
 }
 
+inline const Cost* Functor_getCostXYZ::row(Value vx, Value vy, ptrdiff_t& stride, const Cost*& deltasZ, Cost& delta) const
+{
+    unsigned int ix = obj.x->toIndex(vx);
+    unsigned int iy = obj.y->toIndex(vy);
+    stride = 1;
+    deltasZ = costData(obj.deltaCostsZ);
+    delta = obj.deltaCostsX[ix] + obj.deltaCostsY[iy];
+    return obj.costs.data() + (size_t)ix * obj.sizeY * obj.sizeZ + (size_t)iy * obj.sizeZ;
+}
+inline const Cost* Functor_getCostYXZ::row(Value vy, Value vx, ptrdiff_t& stride, const Cost*& deltasZ, Cost& delta) const
+{
+    unsigned int ix = obj.x->toIndex(vx);
+    unsigned int iy = obj.y->toIndex(vy);
+    stride = 1;
+    deltasZ = costData(obj.deltaCostsZ);
+    delta = obj.deltaCostsX[ix] + obj.deltaCostsY[iy];
+    return obj.costs.data() + (size_t)ix * obj.sizeY * obj.sizeZ + (size_t)iy * obj.sizeZ;
+}
+inline const Cost* Functor_getCostZXY::row(Value vz, Value vx, ptrdiff_t& stride, const Cost*& deltasY, Cost& delta) const
+{
+    unsigned int ix = obj.x->toIndex(vx);
+    unsigned int iz = obj.z->toIndex(vz);
+    stride = obj.sizeZ;
+    deltasY = costData(obj.deltaCostsY);
+    delta = obj.deltaCostsX[ix] + obj.deltaCostsZ[iz];
+    return obj.costs.data() + (size_t)ix * obj.sizeY * obj.sizeZ + iz;
+}
+
 inline Cost Functor_getCostWithBinariesXYZ::operator()(EnumeratedVariable* xx, EnumeratedVariable* yy, EnumeratedVariable* zz, Value vx, Value vy, Value vz) const
 {
     assert(xx == obj.x);
@@ -1376,6 +1408,20 @@ void TernaryConstraint::findSupport(T1 getCost, bool functionalY, T2 getFunction
                         }
                     }
                 }
+            } else if (!costs.empty() && z->getDomainSize() == (unsigned int)(z->getSup() - z->getInf() + 1)) {
+                // no hole in the domain of z: vectorized scan of the rows of the (y,z) slice of vx, in the same order as below
+                unsigned int first = z->toIndex(z->getInf());
+                for (EnumeratedVariable::iterator iterY = y->begin(); minCost > MIN_COST && iterY != y->end(); ++iterY) {
+                    ptrdiff_t stride = 0;
+                    const Cost* deltasZ = NULL;
+                    Cost delta = MIN_COST;
+                    const Cost* row = getCost.row(*iterX, *iterY, stride, deltasZ, delta);
+                    Cost cost = MIN_COST;
+                    unsigned int i = BinaryConstraint::minCostIndex(row + first * stride, stride, deltasZ + first, NULL, z->getDomainSize(), delta, cost);
+                    if (GLB(&minCost, cost - delta)) {
+                        support = make_pair(*iterY, z->toValue(first + i));
+                    }
+                }
             } else {
                 for (EnumeratedVariable::iterator iterY = y->begin(); minCost > MIN_COST && iterY != y->end(); ++iterY) {
                     for (EnumeratedVariable::iterator iterZ = z->begin(); minCost > MIN_COST && iterZ != z->end(); ++iterZ) {
@@ -0,0 +1,221 @@
+/*
+ * ****** Compact storage of the tuples of a cost function given in extension *******
+ */
+
+#include "tb2tuples.hpp"
+
+const unsigned int TupleStore::EMPTY;
+const unsigned int TupleStore::ERASED;
+
+/*
+ * Constructors and misc.
+ *
+ */
+
+TupleStore::TupleStore(const vector<unsigned int>& domainSizes)
+    : arity(domainSizes.size())
+    , nbWords(1)
+    , nbTuples(0)
+    , head(0)
+    , sorted(true)
+    , nbUsedSlots(0)
+{
+    unsigned int pos = 0;
+    for (int i = 0; i < arity; i++) {
+        int width = 1;
+        while (width < WORD_BITS && ((Word)1 << width) < domainSizes[i])
+            width++;
+        if (pos % WORD_BITS + width > WORD_BITS)
+            pos += WORD_BITS - pos % WORD_BITS; // a value is never split between two words
+        words.push_back(pos / WORD_BITS);
+        shifts.push_back(WORD_BITS - pos % WORD_BITS - width);
+        masks.push_back((width == WORD_BITS) ? ~(Word)0 : (((Word)1 << width) - 1));
+        pos += width;
+    }
+    nbWords = max(1u, (pos + WORD_BITS - 1) / WORD_BITS);
+    rehash(16);
+}
+
+void TupleStore::pack(const String& t, Word* key) const
+{
+    assert((int)t.size() == arity);
+    std::fill(key, key + nbWords, 0);
+    for (int i = 0; i < arity; i++) {
+        assert((Word)(t[i] - CHAR_FIRST) <= masks[i]);
+        key[words[i]] |= (Word)(t[i] - CHAR_FIRST) << shifts[i];
+    }
+}
+
+void TupleStore::unpack(const Word* key, String& t) const
+{
+    t.resize(arity);
+    for (int i = 0; i < arity; i++) {
+        t[i] = ((key[words[i]] >> shifts[i]) & masks[i]) + CHAR_FIRST;
+    }
+}
+
+size_t TupleStore::hash(const Word* key) const
+{
+    Word h = 0;
+    for (int w = 0; w < nbWords; w++) {
+        h ^= key[w];
+        h *= 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+bool TupleStore::less(size_t i, size_t j) const
+{
+    const Word* ki = &keys[i * nbWords];
+    const Word* kj = &keys[j * nbWords];
+    for (int w = 0; w < nbWords; w++) {
+        if (ki[w] != kj[w])
+            return ki[w] < kj[w];
+    }
+    return false;
+}
+
+/*
+ * Hash table with linear probing
+ *
+ */
+
+ptrdiff_t TupleStore::lookup(const Word* key) const
+{
+    size_t mask = table.size() - 1;
+    for (size_t slot = hash(key) & mask; table[slot] != EMPTY; slot = (slot + 1) & mask) {
+        if (table[slot] != ERASED) {
+            size_t pos = table[slot] - 1;
+            if (std::equal(key, key + nbWords, &keys[pos * nbWords]))
+                return pos;
+        }
+    }
+    return -1;
+}
+
+void TupleStore::rehash(size_t capacity)
+{
+    size_t size = 16;
+    while (size < 2 * capacity)
+        size *= 2;
+    table.assign(size, EMPTY);
+    nbUsedSlots = 0;
+    size_t mask = size - 1;
+    for (size_t pos = 0; pos < erased.size(); pos++) {
+        if (!erased[pos]) {
+            size_t slot = hash(&keys[pos * nbWords]) & mask;
+            while (table[slot] != EMPTY)
+                slot = (slot + 1) & mask;
+            table[slot] = pos + 1;
+            nbUsedSlots++;
+        }
+    }
+}
+
+Cost* TupleStore::find(const String& t)
+{
+    Word key[nbWords];
+    pack(t, key);
+    ptrdiff_t pos = lookup(key);
+    return (pos >= 0) ? &costs[pos] : NULL;
+}
+
+Cost& TupleStore::operator[](const String& t)
+{
+    Word key[nbWords];
+    pack(t, key);
+    ptrdiff_t pos = lookup(key);
+    if (pos >= 0)
+        return costs[pos];
+
+    pos = erased.size();
+    if (pos + 1 >= (ptrdiff_t)ERASED) {
+        cerr << "Error: too many tuples in a cost function!" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (sorted && pos > 0) {
+        const Word* last = &keys[(pos - 1) * nbWords];
+        sorted = std::lexicographical_compare(last, last + nbWords, key, key + nbWords);
+    }
+    keys.insert(keys.end(), key, key + nbWords);
+    costs.push_back(MIN_COST);
+    erased.push_back(false);
+    nbTuples++;
+    if (2 * (nbUsedSlots + 1) > table.size()) {
+        rehash(nbTuples);
+    } else {
+        size_t mask = table.size() - 1;
+        size_t slot = hash(key) & mask;
+        while (table[slot] != EMPTY)
+            slot = (slot + 1) & mask;
+        table[slot] = pos + 1;
+        nbUsedSlots++;
+    }
+    return costs[pos];
+}
+
+void TupleStore::erase(const iterator& it)
+{
+    assert(it.store == this);
+    assert(it.pos < erased.size() && !erased[it.pos]);
+    size_t mask = table.size() - 1;
+    size_t slot = hash(&keys[it.pos * nbWords]) & mask;
+    while (table[slot] != it.pos + 1)
+        slot = (slot + 1) & mask;
+    table[slot] = ERASED;
+    erased[it.pos] = true;
+    nbTuples--;
+    if (it.pos == head) {
+        while (head < erased.size() && erased[head])
+            head++;
+    }
+}
+
+/*
+ * Iteration in lexicographic order
+ *
+ */
+
+void TupleStore::sort()
+{
+    vector<size_t> order;
+    order.reserve(nbTuples);
+    for (size_t pos = 0; pos < erased.size(); pos++) {
+        if (!erased[pos])
+            order.push_back(pos);
+    }
+    if (!sorted)
+        std::sort(order.begin(), order.end(), [this](size_t i, size_t j) { return less(i, j); });
+    vector<Word> newkeys;
+    vector<Cost> newcosts;
+    newkeys.reserve(nbTuples * nbWords);
+    newcosts.reserve(nbTuples);
+    for (size_t i = 0; i < order.size(); i++) {
+        newkeys.insert(newkeys.end(), &keys[order[i] * nbWords], &keys[order[i] * nbWords] + nbWords);
+        newcosts.push_back(costs[order[i]]);
+    }
+    keys.swap(newkeys);
+    costs.swap(newcosts);
+    erased.assign(nbTuples, false);
+    head = 0;
+    sorted = true;
+    rehash(nbTuples);
+}
+
+TupleStore::iterator TupleStore::begin()
+{
+    if (!sorted || erased.size() - head > 2 * nbTuples) // sort or remove (most) erased tuples
+        sort();
+    iterator it(this, head);
+    if (it.pos < erased.size() && erased[it.pos])
+        ++it;
+    return it;
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
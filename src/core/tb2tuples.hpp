@@ -0,0 +1,108 @@
+/** \file tb2tuples.hpp
+ *  \brief Compact storage of the tuples of a cost function given in extension.
+ *
+ *  Each tuple (a ::String of value indexes plus ::CHAR_FIRST) is packed into a fixed number of 64-bit words,
+ *  using for each variable the number of bits needed by its initial domain size, the first variable in the most significant bits.
+ *  Comparing packed keys word by word gives the lexicographic order of tuples.
+ *
+ *  Tuples and their costs are stored in two contiguous arrays (in insertion order), indexed by a flat open-addressing hash table on the packed keys.
+ *  Iteration is done in lexicographic order, as with a map<String, Cost>: the arrays are sorted (and erased tuples are compacted) at the beginning of an iteration if needed.
+ *
+ *  \note Costs can be modified and tuples erased or inserted during an iteration (inserted tuples being visited at the end).
+ *  \warning TupleStore::begin may reorder the stored tuples, invalidating all other iterators.
+ */
+
+#ifndef TB2TUPLES_HPP_
+#define TB2TUPLES_HPP_
+
+#include "tb2types.hpp"
+
+class TupleStore {
+    typedef unsigned long long Word;
+    static const int WORD_BITS = 8 * sizeof(Word);
+    static const unsigned int EMPTY = 0; // free slot of the hash table
+    static const unsigned int ERASED = UINT_MAX; // slot of an erased tuple
+
+    int arity;
+    vector<unsigned int> words; // position of the value of each variable in a packed key
+    vector<int> shifts;
+    vector<Word> masks;
+    int nbWords; // number of words per packed key
+
+    vector<Word> keys; // nbWords words per stored tuple
+    vector<Cost> costs;
+    vector<bool> erased;
+    size_t nbTuples; // number of tuples not erased
+    size_t head; // no tuple before this position if sorted
+    bool sorted; // true if tuples are stored in lexicographic order
+
+    vector<unsigned int> table; // position plus one of a stored tuple, EMPTY or ERASED
+    size_t nbUsedSlots; // number of slots not EMPTY
+
+    void pack(const String& t, Word* key) const;
+    void unpack(const Word* key, String& t) const;
+    size_t hash(const Word* key) const;
+    bool less(size_t i, size_t j) const;
+    ptrdiff_t lookup(const Word* key) const; ///< \return position of the tuple with this key or -1 if not stored
+    void rehash(size_t capacity);
+    void sort(); // also removes erased tuples
+
+public:
+    class iterator {
+        TupleStore* store;
+        size_t pos;
+
+    public:
+        iterator()
+            : store(NULL)
+            , pos(0)
+        {
+        }
+        iterator(TupleStore* s, size_t p)
+            : store(s)
+            , pos(p)
+        {
+        }
+
+        void tuple(String& t) const { store->unpack(&store->keys[pos * store->nbWords], t); }
+        Cost& cost() const { return store->costs[pos]; }
+
+        iterator& operator++()
+        { // Prefix form
+            pos++;
+            while (pos < store->erased.size() && store->erased[pos])
+                pos++;
+            return *this;
+        }
+
+        bool operator==(const iterator& iter) const { return pos == iter.pos; }
+        bool operator!=(const iterator& iter) const { return pos != iter.pos; }
+
+        friend class TupleStore;
+    };
+
+    /// \param domainSizes initial domain size of each variable in the scope
+    TupleStore(const vector<unsigned int>& domainSizes);
+
+    size_t size() const { return nbTuples; }
+    bool empty() const { return nbTuples == 0; }
+    Long space() const { return (Long)nbTuples * (nbWords * sizeof(Word) + sizeof(Cost)) + (Long)table.size() * sizeof(unsigned int); } ///< \brief memory space in bytes (not counting erased tuples)
+
+    /// \return a pointer to the cost of tuple \a t or NULL if not stored
+    Cost* find(const String& t);
+    /// \brief returns a reference to the cost of tuple \a t, inserting it with a zero cost if not stored (as map::operator[])
+    Cost& operator[](const String& t);
+    void erase(const iterator& it);
+
+    iterator begin();
+    iterator end() { return iterator(this, erased.size()); }
+};
+
+#endif /*TB2TUPLES_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
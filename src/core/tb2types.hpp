@@ -49,6 +49,10 @@ const Value MAX_DOMAIN_SIZE = 2000;
 // For very large domains with ternary cost functions, use NARYPROJECTIONSIZE=2 instead of 3
 const int NARYPROJECTIONSIZE = 3; // limit on the number of unassigned variables before nary constraints are projected to smaller-arity constraint (should be between 1 and 3)
 const Long NARYDECONNECTSIZE = 4; // maximum number of initial tuples in nary constraints in order to check for its removal (if it is always satisfied by current domains)
+const Long SPARSEBINARYSIZE = 65536; // minimum number of tuples of a binary cost function in order to store only its costs different from its most frequent cost
+const int SPARSEBINARYRATIO = 16; // a binary cost function is stored as a sparse table if at most one tuple out of SPARSEBINARYRATIO has a cost different from its most frequent cost
+const int DUALASCENTWINDOW = 50; // dual ascent in preprocessing (-M and -trws) stops if the lower bound did not increase during this number of iterations
+const Long VACPARALLELSIZE = 262144; // minimum number of value pairs of the binary cost functions of a variable in order to seek their supports in Bool(P) with several threads during VAC Pass1 (or to run Min Sum Diffusion on a color class)
 
 const int MAX_BRANCH_SIZE = 1000000;
 const ptrdiff_t CHOICE_POINT_LIMIT = SIZE_MAX - MAX_BRANCH_SIZE;
@@ -361,7 +365,11 @@ public:
     static int elimDegree_;
     static int elimDegree_preprocessing_;
     static int elimSpaceMaxMB;
+    static int miniBucket; // i-bound of mini-bucket elimination in preprocessing (0 if not used)
+    static int miniBucketMaxMB; // memory reserved for mini-bucket cost tables (in MB)
+    static int miniBucketSpillMB; // size of the memory-mapped scratch file for mini-bucket cost tables (in MB, 0 if not used)
     static int minsumDiffusion;
+    static int trws; // number of forward and backward passes of TRW-S like sequential dual ascent in preprocessing (0 if not used)
     static int preprocessTernaryRPC;
     static int preprocessFunctional;
     static bool costfuncSeparate;
@@ -401,6 +409,7 @@ public:
     static int pedigreeCorrectionMode;
     static int pedigreePenalty;
     static int vac;
+    static int vacIncremental; // if positive, VAC in search starts from the threshold of the parent node, only from its modified variables, with this initial limit on the number of VAC iterations per node
     static string costThresholdS;
     static string costThresholdPreS;
     static Cost costThreshold;
@@ -413,6 +422,7 @@ public:
     static LcLevelType LcLevel;
     static bool wcnf;
     static bool qpbo;
+    static bool wcspbin;
 
     static char* varOrder;
     static int btdMode;
@@ -480,6 +490,13 @@ public:
     static Long hbfsBeta; // inverse of maximum node redundancy goal limit
     static ptrdiff_t hbfsCPLimit; // limit on the number of choice points stored inside open node list
     static ptrdiff_t hbfsOpenNodeLimit; // limit on the number of open nodes
+    static bool hbfsIncremental; // if true, restores an open node from its deepest common ancestor with the previously restored open node (sequential search without tree decomposition)
+
+    static int costCheckpoint; // bitmask of cost function classes whose cost tables are checkpointed by copy-on-write pages instead of trailed (1: binary, 2: ternary)
+
+    static int portfolio; // number of racing solver processes sharing their upper bound (0 if no portfolio)
+    static int hbfsWorkers; // number of worker processes sharing open nodes in hybrid best-first search (0 if sequential search)
+    static int nbThreads; // number of threads used to read cost tables and to enforce VAC Pass1 and Min Sum Diffusion (0 if as many as cores)
 
     static bool verifyOpt; // if true, for debugging purposes, checks the given optimal solution (problem.sol) is not pruned during search
     static Cost verifiedOptimum; // for debugging purposes, cost of the given optimal solution
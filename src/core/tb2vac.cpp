@@ -3,7 +3,9 @@
  *
  *      \defgroup VAC Virtual Arc Consistency enforcing
  *  The three phases of VAC are enforced in three different "Pass".
- *  Bool(P) is never built. Instead specific functions (getVACCost) booleanize the WCSP on the fly.
+ *  Bool(P) is never fully built. Instead specific functions (getVACCost) booleanize the WCSP on the fly,
+ *  and Pass1 keeps Bool(P) domains and the rows of binary cost functions as bitsets built lazily at each iteration,
+ *  supports being found by word-parallel operations (in several threads for variables with many neighbors, see ToulBar2::nbThreads).
  *  The domain variables of Bool(P) are the original variable domains (saved and restored using trailing at each iteration) 
  *  All the counter data-structures (k) are timestamped to avoid clearing them at each iteration.
  *  \note Simultaneously AC (and potentially DAC, EAC) are maintained by proper queuing.
@@ -12,6 +14,7 @@
 
 #include "tb2vac.hpp"
 #include "search/tb2clusters.hpp"
+#include "utils/tb2threads.hpp"
 
 class tVACStat {
 public:
@@ -34,9 +37,14 @@ bool cmp_function(tVACStat* v1, tVACStat* v2)
 
 VACExtension::VACExtension(WCSP* w)
     : wcsp(w)
-    , VAC2(&Store::storeVariable)
+    , VAC2(&Store::trail)
     , nbIterations(0)
     , inconsistentVariable(-1)
+    , warmThreshold(MIN_COST)
+    , startIteration(0)
+    , maxIterations(0)
+    , improved(false)
+    , adapted(false)
 {
     queueP = new stack<pair<int, int> >;
     queueR = new stack<pair<int, int> >;
@@ -62,6 +70,7 @@ void VACExtension::init()
         xi = (VACVariable*)wcsp->getVar(i);
         xi->setThreshold(MIN_COST);
     }
+    maxIterations = ToulBar2::vacIncremental;
     iniThreshold();
     nearIncVar = NULL;
 
@@ -121,10 +130,28 @@ void VACExtension::iniThreshold()
         histogram();
     list<Cost>::iterator it = (scaleVAC.begin());
     Cost c = ((it == scaleVAC.end()) ? UNIT_COST : (*it));
+    if (incremental() && warmThreshold > MIN_COST && warmThreshold < c)
+        c = warmThreshold;
     if (wcsp->getUb() < c)
         c = wcsp->getUb();
     itThreshold = c;
     nearIncVar = NULL;
+    startIteration = nbIterations;
+    improved = false;
+    adapted = false;
+}
+
+void VACExtension::adaptIterations()
+{
+    if (adapted)
+        return;
+    adapted = true;
+    if (improved) {
+        if (nbIterations - startIteration >= maxIterations && maxIterations < 16 * ToulBar2::vacIncremental)
+            maxIterations *= 2;
+    } else if (maxIterations > 1) {
+        maxIterations /= 2;
+    }
 }
 
 void VACExtension::nextScaleCost()
@@ -155,6 +182,7 @@ void VACExtension::reset()
     wcsp->revise(NULL);
     VACVariable* x;
     TreeDecomposition* td = wcsp->getTreeDec();
+    bool incr = incremental();
     clear();
     while (!queueP->empty())
         queueP->pop();
@@ -169,7 +197,7 @@ void VACExtension::reset()
         for (VariableList::iterator iter = varlist->begin();
              iter != varlist->end();) {
             x = (VACVariable*)*iter;
-            if (x->unassigned() && (x->getMaxCost() >= itThreshold)) {
+            if (x->unassigned() && (x->getMaxCost() >= itThreshold) && (!incr || x->isTouched())) {
                 if (td) {
                     if (td->isActiveAndInCurrentClusterSubTree(x->getCluster()))
                         x->queueVAC();
@@ -209,6 +237,11 @@ bool VACExtension::propagate()
     bool acSupportOK = false;
 
     while ((!util || isvac) && itThreshold != MIN_COST) {
+        if (incremental() && nbIterations - startIteration >= maxIterations) { // work limit at this search node
+            adaptIterations();
+            inconsistentVariable = -1;
+            break;
+        }
         minlambda = wcsp->getUb() - wcsp->getLb();
         nbIterations++;
         reset();
@@ -262,6 +295,16 @@ bool VACExtension::propagate()
             if (ToulBar2::verbose > 0)
                 cout << "VAC dual bound: " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->getDDualBound() << std::setprecision(DECIMAL_POINT) << "    incvar: " << inconsistentVariable << "    minlambda: " << minlambda << "      itThreshold: " << itThreshold << endl;
             util = enforcePass3();
+            if (util && !improved) {
+                improved = true;
+                if (ToulBar2::vacIncremental) {
+                    // children start one scale level above the first threshold which increased the lower bound here
+                    Cost c = MIN_COST;
+                    for (list<Cost>::iterator it = scaleVAC.begin(); it != scaleVAC.end() && *it > itThreshold; ++it)
+                        c = *it;
+                    warmThreshold = c;
+                }
+            }
         } else {
             nextScaleCost();
             //if(nearIncVar) cout << "var: " << nearIncVar->wcspIndex << "  at Cost: " << atThreshold << endl;
@@ -284,6 +327,13 @@ bool VACExtension::propagate()
             }
         }
     }
+    if (ToulBar2::vacIncremental) {
+        if (incremental() && itThreshold == MIN_COST)
+            adaptIterations();
+        for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++)
+            if (wcsp->getVar(i)->enumerated() && wcsp->getVar(i)->unassigned())
+                ((VACVariable*)wcsp->getVar(i))->untouch();
+    }
     //  updateStat(wcsp->getLb() - lb);
     //if(isvac) assert(checkPass1());
     return util;
@@ -296,7 +346,7 @@ int VACExtension::getHeuristic()
     return -1;
 }
 
-bool VACExtension::enforcePass1(VACVariable* xj, VACBinaryConstraint* cij)
+bool VACExtension::enforcePass1(VACVariable* xj, VACBinaryConstraint* cij, bool seeked)
 {
     bool wipeout = false;
     VACVariable* xi;
@@ -307,7 +357,7 @@ bool VACExtension::enforcePass1(VACVariable* xj, VACBinaryConstraint* cij)
         if (xi->getVACCost(v) != MIN_COST) {
             xi->removeVAC(v);
         } // xi->queueVAC(); }
-        else if (cij->revise(xi, v)) {
+        else if (cij->revise(xi, v, seeked)) {
             wipeout = xi->removeVAC(v);
             xi->setKiller(v, xj->wcspIndex);
             xj->killedOne(); // HEUR
@@ -342,6 +392,7 @@ void VACExtension::enforcePass1()
 
     while (!VAC.empty()) {
         xj = (VACVariable*)VAC.pop_first();
+        bool seeked = seekSupports(xj);
         //list<Constraint*> l;
         for (ConstraintList::iterator itc = xj->getConstrs()->begin();
              itc != xj->getConstrs()->end(); ++itc) {
@@ -350,7 +401,7 @@ void VACExtension::enforcePass1()
                 cij = (VACBinaryConstraint*)c;
                 //        xi = (VACVariable *)cij->getVarDiffFrom(xj);
                 //if(xj->getMaxK(nbIterations) > 2) l.push_back(cij); else
-                if (enforcePass1(xj, cij))
+                if (enforcePass1(xj, cij, seeked))
                     return;
             }
         }
@@ -363,6 +414,32 @@ void VACExtension::enforcePass1()
     inconsistentVariable = -1;
 }
 
+bool VACExtension::seekSupports(VACVariable* xj)
+{
+    int nbThreads = getNbThreads();
+    if (nbThreads <= 1)
+        return false;
+    static vector<VACBinaryConstraint*> constrs; /// \warning NOT SAFE FOR MULTITHREADING!!!
+    constrs.clear();
+    Long size = 0;
+    for (ConstraintList::iterator itc = xj->getConstrs()->begin(); itc != xj->getConstrs()->end(); ++itc) {
+        Constraint* c = (*itc).constr;
+        if (c->arity() == 2 && !c->isSep()) {
+            VACBinaryConstraint* cij = (VACBinaryConstraint*)c;
+            constrs.push_back(cij);
+            size += (Long)cij->getVarDiffFrom(xj)->getDomainSize() * xj->getDomainSize();
+        }
+    }
+    if (constrs.size() <= 1 || size < VACPARALLELSIZE)
+        return false;
+    // bitsets are built before starting the threads which only modify their own cost function
+    xj->setBits(nbIterations);
+    for (VACBinaryConstraint* cij : constrs)
+        ((VACVariable*)cij->getVarDiffFrom(xj))->setBits(nbIterations);
+    parallelFor(constrs.size(), nbThreads, [&](size_t i) { constrs[i]->seekSupports((VACVariable*)constrs[i]->getVarDiffFrom(xj), nbIterations); });
+    return true;
+}
+
 bool VACExtension::checkPass1() const
 {
     VACBinaryConstraint* cij;
@@ -756,33 +833,125 @@ void VACExtension::printTightMatrix()
     }
 }
 
-/* Min-Sum diffusion algorithm */
-void VACExtension::minsumDiffusion()
+/* Greedy coloring such that variables of the same color have no cost function in common (their min-sum diffusion steps are independent) */
+void VACExtension::colorVariables(vector<vector<VACVariable*> >& colors)
 {
-    for (int times = 0; times < 2; times++) {
-        bool change = true;
-        int maxit = ToulBar2::minsumDiffusion;
-        cout << "MinSumDiffusion: " << endl;
-        cout << "   max iterations " << maxit << endl;
-        cout << "   dual bound = " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->getDDualBound() << std::setprecision(DECIMAL_POINT) << endl;
-        int ntimes = 0;
-        while (change && (ntimes < maxit)) {
-            change = false;
-            int nchanged = 0;
-            for (unsigned int i = 0; i < wcsp->numberOfVariables();
-                 i++)
-                if (wcsp->unassigned(i)) {
-                    VACVariable* evar = (VACVariable*)wcsp->getVar(i);
-                    if (evar->averaging()) {
-                        change = true;
-                        nchanged++;
-                        evar->findSupport();
+    colors.clear();
+    vector<int> color(wcsp->numberOfVariables(), -1);
+    vector<int> forbidden; // forbidden[c] == i if color c is already used by a neighbor of the i-th variable
+    for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++)
+        if (wcsp->unassigned(i)) {
+            VACVariable* x = (VACVariable*)wcsp->getVar(i);
+            for (ConstraintList::iterator itc = x->getConstrs()->begin(); itc != x->getConstrs()->end(); ++itc) {
+                Constraint* ctr = (*itc).constr;
+                if ((ctr->isBinary() || ctr->isTernary() || ctr->isNary()) && !ctr->isSep()) {
+                    for (int k = 0; k < ctr->arity(); k++) {
+                        int c = color[ctr->getVar(k)->wcspIndex];
+                        if (c >= 0)
+                            forbidden[c] = i;
                     }
                 }
-            ntimes++;
-            //cout << "it " << ntimes << "   changed: " << nchanged << endl;
+            }
+            unsigned int c = 0;
+            while (c < colors.size() && forbidden[c] == (int)i)
+                c++;
+            if (c == colors.size()) {
+                colors.push_back(vector<VACVariable*>());
+                forbidden.push_back(-1);
+            }
+            color[i] = c;
+            colors[c].push_back(x);
+        }
+}
+
+/* One iteration of min-sum diffusion, color by color, the variables of the same color being averaged in parallel (same result as a sequential pass in this order) */
+bool VACExtension::diffusionPass(const vector<vector<VACVariable*> >& colors)
+{
+    int nbThreads = (Store::getDepth() == 0) ? getNbThreads() : 1; // cost modifications are not trailed at depth zero only
+    bool change = false;
+    vector<char> changed;
+    for (const vector<VACVariable*>& vars : colors) {
+        Long size = 0;
+        for (VACVariable* x : vars)
+            size += (Long)x->getDomainSize() * x->getDomainSize() * x->getDegree();
+        changed.assign(vars.size(), false);
+        parallelFor(vars.size(), (size < VACPARALLELSIZE) ? 1 : nbThreads, [&](size_t i) {
+            if (vars[i]->unassigned())
+                changed[i] = vars[i]->averaging(true);
+        });
+        for (unsigned int i = 0; i < vars.size(); i++)
+            if (changed[i]) {
+                change = true;
+                vars[i]->queueNC();
+                vars[i]->queueDAC();
+                vars[i]->queueEAC1();
+                vars[i]->findSupport();
+            }
+    }
+    return change;
+}
+
+/* One sequential pass of TRW-S like message passing in DAC order (or reverse DAC order) */
+bool VACExtension::trwsPass(bool forward)
+{
+    vector<VACVariable*> order;
+    for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++)
+        if (wcsp->unassigned(i))
+            order.push_back((VACVariable*)wcsp->getVar(i));
+    stable_sort(order.begin(), order.end(), [forward](VACVariable* x, VACVariable* y) { return (forward) ? (x->getDACOrder() < y->getDACOrder()) : (x->getDACOrder() > y->getDACOrder()); });
+    bool change = false;
+    for (VACVariable* x : order)
+        if (x->unassigned() && x->sendMessages(forward)) {
+            change = true;
+            x->findSupport();
+        }
+    return change;
+}
+
+/* Iterates min-sum diffusion (or TRW-S if colors is NULL) until no cost moves, maxit iterations, or no dual bound increase during DUALASCENTWINDOW iterations */
+void VACExtension::dualAscent(int maxit, const vector<vector<VACVariable*> >* colors)
+{
+    cout << ((colors) ? "MinSumDiffusion: " : "TRW-S: ") << endl;
+    cout << "   max iterations " << maxit << endl;
+    if (colors)
+        cout << "   colors " << colors->size() << endl;
+    cout << "   dual bound = " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->getDDualBound() << std::setprecision(DECIMAL_POINT) << endl;
+    Cost bestlb = wcsp->getLb();
+    int lastimprovement = 0;
+    int ntimes = 0;
+    bool change = true;
+    while (change && ntimes < maxit && ntimes - lastimprovement < DUALASCENTWINDOW) {
+        if (colors) {
+            change = diffusionPass(*colors);
+        } else {
+            change = trwsPass(true);
+            change = trwsPass(false) || change;
+        }
+        ntimes++;
+        if (wcsp->getLb() > bestlb) {
+            bestlb = wcsp->getLb();
+            lastimprovement = ntimes;
+        }
+        if (ToulBar2::verbose >= 1)
+            cout << "   iteration " << ntimes << " dual bound = " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->getDDualBound() << std::setprecision(DECIMAL_POINT) << endl;
+    }
+    cout << "   done iterations: " << ntimes;
+    if (change && ntimes < maxit)
+        cout << " (no dual bound increase during the last " << DUALASCENTWINDOW << " iterations)";
+    cout << endl;
+}
+
+/* Dual ascent in preprocessing: Min-Sum diffusion algorithm and/or TRW-S like sequential message passing */
+void VACExtension::minsumDiffusion()
+{
+    for (int times = 0; times < 2; times++) {
+        if (ToulBar2::minsumDiffusion > 0) {
+            vector<vector<VACVariable*> > colors;
+            colorVariables(colors);
+            dualAscent(ToulBar2::minsumDiffusion, &colors);
         }
-        cout << "   done iterations: " << ntimes << endl;
+        if (ToulBar2::trws > 0)
+            dualAscent(ToulBar2::trws, NULL);
         for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++)
             if (wcsp->unassigned(i)) {
                 EnumeratedVariable* evar = (EnumeratedVariable*)wcsp->getVar(i);
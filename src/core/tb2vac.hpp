@@ -26,6 +26,11 @@ private:
     int inconsistentVariable; /**< WipeOut variable, Used also to check after enforcePass1() if the network is VAC */
 
     Cost itThreshold; /**< The cost threshold (theta) for the iterative threshold descent */
+    StoreCost warmThreshold; /**< Threshold where the descent starts in the children of the current search node (incremental VAC, MIN_COST if none) */
+    Long startIteration; /**< First iteration at the current search node (incremental VAC) */
+    Long maxIterations; /**< Adaptive limit on the number of iterations per search node (incremental VAC) */
+    bool improved; /**< Has the lower bound been increased at the current search node? (incremental VAC) */
+    bool adapted; /**< Has maxIterations been updated at the current search node? (incremental VAC) */
     int breakCycles; /**< Number of iterations with no c0 increase */
     tScale scaleCost; /**w The list of all costs used in the WCSP ? */
     list<Cost> scaleVAC; /**< The scale of costs used for the thresold descent */
@@ -36,13 +41,21 @@ private:
     stack<pair<int, Value> >* queueR; /**< Minimal set of deletions needed to increase c0 (created in Pass2, used in Pass3) */
 
     void enforcePass1(); /**< Enforces instrumented hard AC (Phase 1) */
-    bool enforcePass1(VACVariable* xj, VACBinaryConstraint* cij); /**< Revises /a xj wrt /a cij and updates /a k */
+    bool enforcePass1(VACVariable* xj, VACBinaryConstraint* cij, bool seeked = false); /**< Revises /a xj wrt /a cij and updates /a k */
+    bool seekSupports(VACVariable* xj); /**< Seeks in parallel the supports lost by the neighbors of /a xj before revising them (if enough work) */
     bool checkPass1() const; /**< Checks if Bool(P) is AC */
     void enforcePass2(); /**< Finds a minimal set of deletions needed for wipeout and computes k and lambda */
     bool enforcePass3(); /**< Project and extends costs to increase c0 according to the plan */
     void enforcePass3VACDecomposition(); /**< Enforces VAC decomposition pass 3 (substract cost and decrease top) */
 
     void reset(); /**< Cleanup for next iteration: clean Q, selects variables for AC2001 queue */
+    bool incremental() const { return ToulBar2::vacIncremental > 0 && Store::getDepth() > 0; } /**< Is VAC incremental at the current search node? */
+    void adaptIterations(); /**< Doubles or halves the number of iterations per search node depending on the lower bound increases */
+
+    void colorVariables(vector<vector<VACVariable*> >& colors); /**< Partitions unassigned variables into colors such that no cost function has two variables of the same color */
+    bool diffusionPass(const vector<vector<VACVariable*> >& colors); /**< One iteration of Min-Sum diffusion, in parallel inside each color */
+    bool trwsPass(bool forward); /**< One pass of TRW-S like message passing in DAC order (or reverse DAC order if not \a forward) */
+    void dualAscent(int maxit, const vector<vector<VACVariable*> >* colors); /**< Iterates Min-Sum diffusion (TRW-S if \a colors is NULL) with convergence tracking */
 
     map<int, tVACStat*> heapAccess;
     vector<tVACStat*> heap;
@@ -64,6 +77,7 @@ public:
     ~VACExtension();
 
     bool firstTime() { return nbIterations == 0; } /**< Is it the first iteration ? */
+    Long getNbIterations() const { return nbIterations; } /**< Current iteration, used as a TimeStamp */
 
     bool isVAC() const; /**< Is the WCSP VAC-epsilon ? Pass1 must be enforced */
     bool propagate(); /**< Starts one VAC iteration */
@@ -101,7 +115,7 @@ public:
     void printStat(bool ini = false);
     void printTightMatrix();
 
-    void minsumDiffusion(); /**< MinSumDiffusion implementation */
+    void minsumDiffusion(); /**< Dual ascent in preprocessing: parallel Min-Sum diffusion (ToulBar2::minsumDiffusion) and/or TRW-S (ToulBar2::trws) */
 };
 
 #endif /*TB2VAC_HPP_*/
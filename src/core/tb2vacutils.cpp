@@ -10,6 +10,8 @@ VACVariable::VACVariable(WCSP* wcsp, string n, Value iinf, Value isup)
     : EnumeratedVariable(wcsp, n, iinf, isup)
     , vac(wcsp->vac)
     , myThreshold(MIN_COST)
+    , vacSize(-1)
+    , vacMaxCost(MIN_COST)
 {
     init();
 }
@@ -18,6 +20,8 @@ VACVariable::VACVariable(WCSP* wcsp, string n, Value* d, int dsize)
     : EnumeratedVariable(wcsp, n, d, dsize)
     , vac(wcsp->vac)
     , myThreshold(MIN_COST)
+    , vacSize(-1)
+    , vacMaxCost(MIN_COST)
 {
     init();
 }
@@ -42,6 +46,83 @@ void VACVariable::init()
     linkSeekSupport.content.var = this;
     linkSeekSupport.content.timeStamp = -1;
     linkVAC2Queue.content = this;
+    nullBits.resize(getNbWords(), 0);
+    costBits.resize(getNbWords(), 0);
+    bits_timeStamp = -1;
+}
+
+// calls visit(idx) for every bit idx set in bits in the range [lo, hi)
+template <typename Visit>
+static void visitBits(const BitWord* bits, unsigned int lo, unsigned int hi, Visit visit)
+{
+    const int WORD_BITS = VACVariable::WORD_BITS;
+    for (unsigned int w = lo / WORD_BITS; w * WORD_BITS < hi; w++) {
+        BitWord m = bits[w];
+        if (w == lo / WORD_BITS)
+            m &= ~(BitWord)0 << (lo % WORD_BITS);
+        if ((w + 1) * WORD_BITS > hi)
+            m &= ~(~(BitWord)0 << (hi % WORD_BITS));
+        while (m) {
+            visit(w * WORD_BITS + __builtin_ctzll(m));
+            m &= m - 1;
+        }
+    }
+}
+
+// calls visit(idx) for every bit idx set in bits from first up to last excluded, wrapping around the end of bits (all the bits if last < 0)
+template <typename Visit>
+static void visitBitsFrom(const BitWord* bits, unsigned int nbWords, unsigned int first, int last, Visit visit)
+{
+    if (last >= (int)first) {
+        visitBits(bits, first, last, visit);
+    } else {
+        visitBits(bits, first, nbWords * VACVariable::WORD_BITS, visit);
+        visitBits(bits, 0, (last < 0) ? first : last, visit);
+    }
+}
+
+// returns the index of the first bit set in both a and b from first, wrapping around the end of the bitsets (-1 if none)
+static int firstCommonBit(const BitWord* a, const BitWord* b, unsigned int nbWords, unsigned int first)
+{
+    const int WORD_BITS = VACVariable::WORD_BITS;
+    unsigned int w0 = first / WORD_BITS;
+    BitWord m = a[w0] & b[w0] & (~(BitWord)0 << (first % WORD_BITS));
+    if (m)
+        return w0 * WORD_BITS + __builtin_ctzll(m);
+    for (unsigned int w = w0 + 1; w < nbWords; w++)
+        if ((m = a[w] & b[w]))
+            return w * WORD_BITS + __builtin_ctzll(m);
+    for (unsigned int w = 0; w <= w0; w++)
+        if ((m = a[w] & b[w]))
+            return w * WORD_BITS + __builtin_ctzll(m);
+    return -1;
+}
+
+void VACVariable::setBits(Long timeStamp)
+{
+    if (bits_timeStamp == timeStamp)
+        return;
+    bits_timeStamp = timeStamp;
+    fill(nullBits.begin(), nullBits.end(), 0);
+    fill(costBits.begin(), costBits.end(), 0);
+    for (iterator it = begin(); it != end(); ++it) {
+        unsigned int idx = toIndex(*it);
+        if (getVACCost(*it) == MIN_COST)
+            nullBits[idx / WORD_BITS] |= (BitWord)1 << (idx % WORD_BITS);
+        else
+            costBits[idx / WORD_BITS] |= (BitWord)1 << (idx % WORD_BITS);
+    }
+}
+
+void VACVariable::removeCostlyValues(unsigned int first, int last)
+{
+    bool removed = false;
+    visitBitsFrom(costBits.data(), getNbWords(), first, last, [&](unsigned int idx) {
+        removeVAC(toValue(idx));
+        removed = true;
+    });
+    if (removed)
+        queueVAC();
 }
 
 bool VACVariable::increaseVAC(Value newInf)
@@ -72,6 +153,9 @@ bool VACVariable::decreaseVAC(Value newSup)
 
 bool VACVariable::removeVAC(Value v)
 {
+    unsigned int idx = toIndex(v);
+    nullBits[idx / WORD_BITS] &= ~((BitWord)1 << (idx % WORD_BITS));
+    costBits[idx / WORD_BITS] &= ~((BitWord)1 << (idx % WORD_BITS));
     if (v == inf)
         return increaseVAC(v + 1);
     else if (v == sup)
@@ -274,7 +358,7 @@ void VACVariable::decrease(Value newSup)
  * min-sum diffusion algorithm
  */
 
-bool VACVariable::averaging()
+bool VACVariable::averaging(bool delayed)
 {
     Cost Top = wcsp->getUb();
     bool change = false;
@@ -304,7 +388,9 @@ bool VACVariable::averaging()
                     for (iterator itx = x->begin(); itx != x->end(); ++itx) {
                         bctr->addcost(this, x, *it, *itx, costi);
                     }
-                    if (mean > to_double(cu))
+                    if (delayed)
+                        costs[toIndex(*it)] -= costi;
+                    else if (mean > to_double(cu))
                         project(*it, -costi);
                     else
                         extend(*it, costi);
@@ -337,7 +423,9 @@ bool VACVariable::averaging()
                             tctr->addCost(this, x, y, *it, *itx, *ity, costi);
                         }
                     }
-                    if (mean > to_double(cu))
+                    if (delayed)
+                        costs[toIndex(*it)] -= costi;
+                    else if (mean > to_double(cu))
                         project(*it, -costi);
                     else
                         extend(*it, costi);
@@ -367,7 +455,9 @@ bool VACVariable::averaging()
                 if (abs(extc) >= 1) {
                     Cost costi = (Cost)extc;
                     nctr->addtoTuples(this, *it, costi);
-                    if (mean > to_double(cu))
+                    if (delayed)
+                        costs[toIndex(*it)] -= costi;
+                    else if (mean > to_double(cu))
                         project(*it, -costi);
                     else
                         extend(*it, costi);
@@ -384,6 +474,65 @@ bool VACVariable::averaging()
     return change;
 }
 
+/*
+ * TRW-S like message passing: collects the min-marginals of binary cost functions into unary costs
+ * and spreads them again on the binary cost functions with variables after the current variable
+ * (in DAC order if forward or reverse DAC order)
+ */
+bool VACVariable::sendMessages(bool forward)
+{
+    Cost Top = wcsp->getUb();
+    bool change = false;
+    vector<BinaryConstraint*> after;
+    int nbefore = 0;
+    for (ConstraintList::iterator itc = getConstrs()->begin(); itc != getConstrs()->end(); ++itc) {
+        Constraint* ctr = (*itc).constr;
+        if (ctr->isBinary() && !ctr->isSep()) {
+            BinaryConstraint* bctr = (BinaryConstraint*)ctr;
+            EnumeratedVariable* x = (EnumeratedVariable*)bctr->getVarDiffFrom((Variable*)this);
+            for (iterator it = begin(); it != end(); ++it) {
+                Cost cmin = Top;
+                for (iterator itx = x->begin(); itx != x->end(); ++itx) {
+                    Cost cbin = bctr->getCost(this, x, *it, *itx);
+                    if (cbin < cmin)
+                        cmin = cbin;
+                }
+                if (cmin > MIN_COST && cmin < Top) {
+                    for (iterator itx = x->begin(); itx != x->end(); ++itx) {
+                        bctr->addcost(this, x, *it, *itx, -cmin);
+                    }
+                    project(*it, cmin, true);
+                    change = true;
+                }
+            }
+            if ((x->getDACOrder() > getDACOrder()) == forward)
+                after.push_back(bctr);
+            else
+                nbefore++;
+        }
+    }
+    if (after.empty())
+        return change;
+    Cost n = max((Cost)nbefore, (Cost)after.size());
+    for (iterator it = begin(); it != end(); ++it) {
+        Cost cu = getCost(*it);
+        if (CUT(cu + wcsp->getLb(), Top))
+            continue;
+        Cost share = cu / n;
+        if (share > MIN_COST) {
+            for (BinaryConstraint* bctr : after) {
+                EnumeratedVariable* x = (EnumeratedVariable*)bctr->getVarDiffFrom((Variable*)this);
+                for (iterator itx = x->begin(); itx != x->end(); ++itx) {
+                    bctr->addcost(this, x, *it, *itx, share);
+                }
+                extend(*it, share);
+            }
+            change = true;
+        }
+    }
+    return change;
+}
+
 /************************************************************
  * VACBinaryConstraint:
  *   A class that stores information about a binary cost function
@@ -493,68 +642,97 @@ bool VACBinaryConstraint::isNull(Cost c)
     return (xi->isSimplyNull(c) || (c < myThreshold));
 }
 
-bool VACBinaryConstraint::revise(VACVariable* var, Value v)
+const BitWord* VACBinaryConstraint::getRow(VACVariable* var, Value v, Long timeStamp)
+{
+    VACVariable* xj = (VACVariable*)getVarDiffFrom(var);
+    vector<BitWord>& rows = (getIndex(var) == 0) ? rowsX : rowsY;
+    vector<Long>& rows_timeStamp = (getIndex(var) == 0) ? rowsX_timeStamp : rowsY_timeStamp;
+    unsigned int nbWords = xj->getNbWords();
+    unsigned int index = var->toIndex(v);
+    if (rows_timeStamp.size() < var->getDomainInitSize())
+        rows_timeStamp.resize(var->getDomainInitSize(), -1);
+    if (rows.size() < var->getDomainInitSize() * nbWords)
+        rows.resize(var->getDomainInitSize() * nbWords);
+    BitWord* row = &rows[index * nbWords];
+    if (rows_timeStamp[index] < timeStamp) {
+        // only values in the Bool(P) domain of xj are tested as this domain can only shrink during Pass1
+        rows_timeStamp[index] = timeStamp;
+        fill(row, row + nbWords, 0);
+        visitBits(xj->getNullBits(), 0, nbWords * VACVariable::WORD_BITS, [&](unsigned int idx) {
+            if (getVACCost(var, xj, v, xj->toValue(idx)) == MIN_COST)
+                row[idx / VACVariable::WORD_BITS] |= (BitWord)1 << (idx % VACVariable::WORD_BITS);
+        });
+    }
+    return row;
+}
+
+bool VACBinaryConstraint::seekSupport(VACVariable* var, Value v, Value sup, Long timeStamp, Value& newsup)
 {
-    wcsp->revise(this);
-    //  bool wipeout = false;
-    VACVariable* xi = (VACVariable*)getVar(0);
-    VACVariable* xj = (VACVariable*)getVar(1);
-    Value sup = getSupport(var, v);
-    Value minsup = sup;
-    if (var != xi) {
-        xi = (VACVariable*)getVar(1);
-        xj = (VACVariable*)getVar(0);
+    VACVariable* xj = (VACVariable*)getVarDiffFrom(var);
+    xj->setBits(timeStamp);
+    int idx = firstCommonBit(getRow(var, v, timeStamp), xj->getNullBits(), xj->getNbWords(), xj->toIndex(sup));
+    if (idx >= 0) {
+        newsup = xj->toValue(idx);
+        return true;
     }
-    Cost cost, minCost = wcsp->getUb();
+    // no support in Bool(P): first value of minimum cost found from sup
+    Cost minCost = wcsp->getUb();
+    newsup = sup;
+    visitBitsFrom(xj->getNullBits(), xj->getNbWords(), xj->toIndex(sup), -1, [&](unsigned int i) {
+        Cost cost = getVACCost(var, xj, v, xj->toValue(i));
+        if (cost < minCost) {
+            minCost = cost;
+            newsup = xj->toValue(i);
+        }
+    });
+    return false;
+}
+
+void VACBinaryConstraint::seekSupports(VACVariable* var, Long timeStamp)
+{
+    VACVariable* xj = (VACVariable*)getVarDiffFrom(var);
+    if (seekedSupports.size() < var->getDomainInitSize()) {
+        seekedSupports.resize(var->getDomainInitSize());
+        seekedFound.resize(var->getDomainInitSize());
+    }
+    assert(var->getNullBits() && xj->getNullBits());
+    visitBits(var->getNullBits(), 0, var->getNbWords() * VACVariable::WORD_BITS, [&](unsigned int idx) {
+        Value v = var->toValue(idx);
+        Value sup = getSupport(var, v);
+        if (!xj->canbe(sup) || xj->getVACCost(sup) != MIN_COST || getVACCost(var, xj, v, sup) != MIN_COST)
+            seekedFound[idx] = seekSupport(var, v, sup, timeStamp, seekedSupports[idx]);
+    });
+}
+
+bool VACBinaryConstraint::revise(VACVariable* var, Value v, bool seeked)
+{
+    wcsp->revise(this);
+    VACVariable* xi = var;
+    VACVariable* xj = (VACVariable*)getVarDiffFrom(var);
+    Value sup = getSupport(xi, v);
 
     if (xj->canbe(sup)) {
         if (xj->getVACCost(sup) != MIN_COST) {
             xj->removeVAC(sup);
-        } // wipeout = xj->removeVAC(sup);
-        else {
+        } else {
             if (getVACCost(xi, xj, v, sup) == MIN_COST) {
                 return false;
             }
         }
     }
 
-    for (EnumeratedVariable::iterator it = xj->lower_bound(sup); it != xj->end(); ++it) {
-        Value w = *it;
-        if (xj->getVACCost(w) != MIN_COST) {
-            xj->removeVAC(w);
-            xj->queueVAC();
-        } // wipeout = xj->removeVAC(w); xj->queueVAC();
-        else {
-            cost = getVACCost(xi, xj, v, w);
-            if (cost == MIN_COST) {
-                setSupport(xi, v, w);
-                return false;
-            } else if (cost < minCost) {
-                minCost = cost;
-                minsup = w;
-            }
-        }
-    }
-    for (EnumeratedVariable::iterator it = xj->begin(); it != xj->lower_bound(sup); ++it) {
-        Value w = *it;
-        if (xj->getVACCost(w) != MIN_COST) {
-            xj->removeVAC(w);
-            xj->queueVAC();
-        } // wipeout = xj->removeVAC(w); xj->queueVAC();
-        else {
-            cost = getVACCost(xi, xj, v, w);
-            if (cost == MIN_COST) {
-                setSupport(xi, v, w);
-                return false;
-            } else if (cost < minCost) {
-                minCost = cost;
-                minsup = w;
-            }
-        }
+    Value newsup;
+    bool found;
+    if (seeked) {
+        newsup = seekedSupports[xi->toIndex(v)];
+        found = seekedFound[xi->toIndex(v)];
+    } else {
+        found = seekSupport(xi, v, sup, wcsp->vac->getNbIterations(), newsup);
     }
-
-    setSupport(xi, v, minsup);
-    return true;
+    // values with a non-null unary cost met before the support (or all of them) are removed from Bool(P)
+    xj->removeCostlyValues(xj->toIndex(sup), (found) ? (int)xj->toIndex(newsup) : -1);
+    setSupport(xi, v, newsup);
+    return !found;
 }
 
 /************************************************************
@@ -19,6 +19,10 @@ private:
     vector<int> k; /**< Number of cost requests per value for all cost functions */
     vector<int> killer; /**< The killer of each value : the other variable index (binary case)*/
 
+    vector<BitWord> nullBits; /**< Bool(P) domain in Pass1: bit idx is set if value toValue(idx) is in the domain with a null unary cost */
+    vector<BitWord> costBits; /**< bit idx is set if value toValue(idx) is in the domain with a non-null unary cost (removed lazily in Pass1) */
+    Long bits_timeStamp; /**< timestamp of nullBits and costBits */
+
     int killed; /**< How many values did this variable killed ? HEUR */
     int maxk; /**< The Max number of cost requests seen on this variable, used for stats */
     Long maxk_timeStamp; /**< timestamp for maxk */
@@ -26,6 +30,9 @@ private:
     StoreCost myThreshold; /** The local thresold used to break loops */
     //Cost 	        myThreshold;
 
+    StoreInt vacSize; /**< Domain size at the last VAC iteration along the current branch (incremental VAC) */
+    StoreCost vacMaxCost; /**< Maximum unary cost at the last VAC iteration along the current branch (incremental VAC) */
+
     DLink<VariableWithTimeStamp> linkVACQueue;
     DLink<VariableWithTimeStamp> linkSeekSupport;
     DLink<Variable*> linkVAC2Queue;
@@ -43,6 +50,12 @@ public:
     bool increaseVAC(Value newInf);
     bool decreaseVAC(Value supInf);
 
+    static const int WORD_BITS = 8 * sizeof(BitWord);
+    unsigned int getNbWords() const { return (getDomainInitSize() + WORD_BITS - 1) / WORD_BITS; }
+    void setBits(Long timeStamp); /**< Computes nullBits and costBits from the current domain if not already done at this timestamp */
+    const BitWord* getNullBits() const { return nullBits.data(); }
+    void removeCostlyValues(unsigned int first, int last); /**< Removes and queues the values with a non-null unary cost from index first up to last excluded, wrapping around (all if last < 0) */
+
     int getMaxK(Long timeStamp)
     {
         if (maxk_timeStamp < timeStamp)
@@ -101,6 +114,15 @@ public:
     void setThreshold(Cost c) { myThreshold = c; }
     Cost getThreshold() { return myThreshold; }
 
+    bool isTouched() { return (int)getDomainSize() != vacSize || getMaxCost() != vacMaxCost; } /**< Has the variable been modified since the last VAC iteration along the current branch? */
+    void untouch()
+    {
+        if (isTouched()) {
+            vacSize = getDomainSize();
+            vacMaxCost = getMaxCost();
+        }
+    }
+
     bool isSimplyNull(Cost c);
     bool isNull(Cost c);
 
@@ -125,7 +147,8 @@ public:
     void VACproject(Value v, const Cost c); /**< Increases unary cost and may queue for NC enforcing */
     void VACextend(Value v, const Cost c); /**< Decreases unary cost and may queue for NC enforcing */
 
-    bool averaging(); /**< For Min-Sum diffusion */
+    bool averaging(bool delayed = false); /**< For Min-Sum diffusion (if \a delayed, unary costs are directly modified without queueing this variable nor removing values) */
+    bool sendMessages(bool forward); /**< For TRW-S like dual ascent in DAC order (or reverse DAC order if not \a forward) */
 
     friend ostream& operator<<(ostream& os, VACVariable& v)
     {
@@ -147,6 +170,16 @@ private:
 
     StoreCost myThreshold; /** The local thresold used to break loops */
 
+    vector<BitWord> rowsX; /**< Bool(P) rows in Pass1: bit idx of row v is set if (v, y->toValue(idx)) has a null cost */
+    vector<BitWord> rowsY; /**< Bool(P) rows in Pass1: bit idx of row v is set if (x->toValue(idx), v) has a null cost */
+    vector<Long> rowsX_timeStamp;
+    vector<Long> rowsY_timeStamp;
+    vector<Value> seekedSupports; /**< Supports found by seekSupports (or minimum cost values if no support) */
+    vector<bool> seekedFound;
+
+    const BitWord* getRow(VACVariable* var, Value v, Long timeStamp); /**< Returns the Bool(P) row of value v of var, built lazily once per timestamp */
+    bool seekSupport(VACVariable* var, Value v, Value sup, Long timeStamp, Value& newsup); /**< Seeks a support of v in Bool(P) starting from sup, or the value of minimum cost if none */
+
 public:
     VACBinaryConstraint(WCSP* wcsp, EnumeratedVariable* xx, EnumeratedVariable* yy, vector<Cost>& tab);
     VACBinaryConstraint(WCSP* wcsp);
@@ -173,7 +206,8 @@ public:
     void VACproject(VACVariable* x, Value v, Cost c); /**< Modifies Delta counters, then VAC projects on value */
     void VACextend(VACVariable* x, Value v, Cost c); /**< Modifies Delta counters, then VAC extends from value */
 
-    bool revise(VACVariable* var, Value v); /**< AC2001 based Revise for Pass1 : Revise value wrt this cost function */
+    bool revise(VACVariable* var, Value v, bool seeked = false); /**< AC2001 based Revise for Pass1 : Revise value wrt this cost function (using the result of seekSupports if seeked) */
+    void seekSupports(VACVariable* var, Long timeStamp); /**< Seeks supports of all values of var whose support is lost, without modifying the network (thread-safe for different cost functions) */
 
     friend ostream& operator<<(ostream& os, VACBinaryConstraint& c)
     {
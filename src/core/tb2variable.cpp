@@ -21,9 +21,9 @@ Variable::Variable(WCSP* w, string n, Value iinf, Value isup)
     , pos(-1)
     , inf(iinf)
     , sup(isup)
-    , constrs(&Store::storeConstraint)
+    , constrs(&Store::trail)
     ,
-    //triangles(&Store::storeConstraint),
+    //triangles(&Store::trail),
     maxCost(MIN_COST)
     , maxCostValue(iinf)
     , NCBucket(-1)
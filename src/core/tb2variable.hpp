@@ -58,6 +58,7 @@ public:
     string getName() const { return name; }
     void newValueName(const string& vname) { valueNames.push_back(vname); }
     string& getValueName(int idx) { return valueNames[idx]; }
+    bool hasValueNames() const { return !valueNames.empty(); }
     int getDACOrder() const { return dac; }
     void setDACOrder(int order) { dac = order; }
     Value getInf() const { return inf; }
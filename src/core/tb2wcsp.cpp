@@ -33,6 +33,7 @@
 #include "globals/tb2maxconstr.hpp"
 #include "tb2clause.hpp"
 #include "tb2clqcover.hpp"
+#include "utils/tb2compression.hpp"
 
 /*
  * Global variables with their default value
@@ -40,10 +41,9 @@
  */
 
 int Store::depth = 0;
-StoreStack<BTList<Value>, DLink<Value>*> Store::storeDomain(STORE_SIZE);
-StoreStack<BTList<ConstraintLink>, DLink<ConstraintLink>*> Store::storeConstraint(STORE_SIZE);
-StoreStack<BTList<Variable*>, DLink<Variable*>*> Store::storeVariable(STORE_SIZE);
-StoreStack<BTList<Separator*>, DLink<Separator*>*> Store::storeSeparator(STORE_SIZE);
+StoreTrail Store::trail(STORE_SIZE);
+Long StoreCostTable::totalSize = 0;
+Long StoreCostTable::maxSize = 0;
 
 int WCSP::wcspCounter = 0;
 
@@ -61,6 +61,9 @@ int ToulBar2::elimDegree_preprocessing;
 int ToulBar2::elimDegree_;
 int ToulBar2::elimDegree_preprocessing_;
 int ToulBar2::elimSpaceMaxMB;
+int ToulBar2::miniBucket;
+int ToulBar2::miniBucketMaxMB;
+int ToulBar2::miniBucketSpillMB;
 int ToulBar2::preprocessTernaryRPC;
 int ToulBar2::preprocessFunctional;
 bool ToulBar2::costfuncSeparate;
@@ -78,6 +81,7 @@ bool ToulBar2::limited;
 Long ToulBar2::restart;
 bool ToulBar2::generation;
 int ToulBar2::minsumDiffusion;
+int ToulBar2::trws;
 bool ToulBar2::Static_variable_ordering;
 int ToulBar2::weightedDegree;
 int ToulBar2::weightedTightness;
@@ -87,6 +91,7 @@ int ToulBar2::DEE_;
 int ToulBar2::nbDecisionVars;
 bool ToulBar2::singletonConsistency;
 bool ToulBar2::vacValueHeuristic;
+int ToulBar2::vacIncremental;
 
 externalevent ToulBar2::setvalue;
 externalevent ToulBar2::setmin;
@@ -136,6 +141,7 @@ unsigned int ToulBar2::decimalPoint;
 BEP* ToulBar2::bep;
 bool ToulBar2::wcnf;
 bool ToulBar2::qpbo;
+bool ToulBar2::wcspbin;
 
 char* ToulBar2::varOrder;
 int ToulBar2::btdMode;
@@ -197,6 +203,13 @@ Long ToulBar2::hbfsAlpha; // inverse of minimum node redundancy goal limit
 Long ToulBar2::hbfsBeta; // inverse of maximum node redundancy goal limit
 ptrdiff_t ToulBar2::hbfsCPLimit; // limit on the number of choice points stored inside open node list
 ptrdiff_t ToulBar2::hbfsOpenNodeLimit; // limit on the number of open nodes
+bool ToulBar2::hbfsIncremental;
+
+int ToulBar2::costCheckpoint;
+
+int ToulBar2::portfolio;
+int ToulBar2::hbfsWorkers;
+int ToulBar2::nbThreads;
 
 bool ToulBar2::verifyOpt;
 Cost ToulBar2::verifiedOptimum;
@@ -221,6 +234,9 @@ void tb2init()
     ToulBar2::elimDegree_ = -1;
     ToulBar2::elimDegree_preprocessing_ = -1;
     ToulBar2::elimSpaceMaxMB = 0;
+    ToulBar2::miniBucket = 0;
+    ToulBar2::miniBucketMaxMB = 1024;
+    ToulBar2::miniBucketSpillMB = 0;
     ToulBar2::preprocessTernaryRPC = 0;
     ToulBar2::preprocessFunctional = 1;
     ToulBar2::costfuncSeparate = true;
@@ -237,6 +253,7 @@ void tb2init()
     ToulBar2::restart = -1;
     ToulBar2::generation = false;
     ToulBar2::minsumDiffusion = 0;
+    ToulBar2::trws = 0;
     ToulBar2::Static_variable_ordering = false;
     ToulBar2::weightedDegree = 1000000;
     ToulBar2::weightedTightness = 0;
@@ -246,6 +263,7 @@ void tb2init()
     ToulBar2::nbDecisionVars = 0;
     ToulBar2::singletonConsistency = false;
     ToulBar2::vacValueHeuristic = true;
+    ToulBar2::vacIncremental = 0;
 
     ToulBar2::setvalue = NULL;
     ToulBar2::setmin = NULL;
@@ -286,6 +304,7 @@ void tb2init()
     ToulBar2::bep = NULL;
     ToulBar2::wcnf = false;
     ToulBar2::qpbo = false;
+    ToulBar2::wcspbin = false;
 
     ToulBar2::varOrder = NULL;
     ToulBar2::btdMode = 0;
@@ -347,6 +366,13 @@ void tb2init()
     ToulBar2::hbfsBeta = 10LL; // i.e., beta = 1/10 = 0.1
     ToulBar2::hbfsCPLimit = CHOICE_POINT_LIMIT;
     ToulBar2::hbfsOpenNodeLimit = OPEN_NODE_LIMIT;
+    ToulBar2::hbfsIncremental = false;
+
+    ToulBar2::costCheckpoint = 0;
+
+    ToulBar2::portfolio = 0;
+    ToulBar2::hbfsWorkers = 0;
+    ToulBar2::nbThreads = 0;
 
     ToulBar2::verifyOpt = false;
     ToulBar2::verifiedOptimum = MAX_COST;
@@ -483,6 +509,30 @@ void tb2checkOptions(Cost ub)
         cout << "Warning! Cannot perform dead-end elimination while verifying that the optimal solution is preserved." << endl;
         ToulBar2::DEE = 0;
     }
+    if (ToulBar2::portfolio > 1 && (ToulBar2::btdMode >= 1 || ToulBar2::searchMethod != DFBB)) {
+        cerr << "Error: portfolio search only works with DFS/HBFS (remove -B or -vns options)." << endl;
+        exit(1);
+    }
+    if (ToulBar2::portfolio > 1 && (ToulBar2::allSolutions || ToulBar2::isZ)) {
+        cerr << "Error: portfolio search cannot count solutions or compute a partition function (remove -a or -logz options)." << endl;
+        exit(1);
+    }
+    if (ToulBar2::hbfsWorkers > 1 && !ToulBar2::hbfs) {
+        cout << "Warning! Parallel hybrid best-first search requires hybrid best-first search (remove -hbfs: option)." << endl;
+        ToulBar2::hbfsWorkers = 0;
+    }
+    if (ToulBar2::hbfsWorkers > 1 && (ToulBar2::btdMode >= 1 || ToulBar2::searchMethod != DFBB || ToulBar2::lds || ToulBar2::restart > 0)) {
+        cerr << "Error: parallel hybrid best-first search only works without tree decomposition, LDS and restarts (remove -B, -vns, -l, -L options)." << endl;
+        exit(1);
+    }
+    if (ToulBar2::hbfsWorkers > 1 && (ToulBar2::allSolutions || ToulBar2::isZ || ToulBar2::portfolio > 1)) {
+        cerr << "Error: parallel hybrid best-first search cannot count solutions, compute a partition function or run inside a portfolio (remove -a, -logz or -portfolio options)." << endl;
+        exit(1);
+    }
+    if (ToulBar2::hbfsIncremental && (!ToulBar2::hbfs || ToulBar2::btdMode >= 1 || ToulBar2::hbfsWorkers > 1)) {
+        cout << "Warning! Incremental restoration of open nodes only works with sequential hybrid best-first search without tree decomposition (remove -hbfsinc option)." << endl;
+        ToulBar2::hbfsIncremental = false;
+    }
 }
 
 /*
@@ -498,8 +548,8 @@ WCSP::WCSP(Cost upperBound, void* _solver_)
     , negCost(MIN_COST)
     , solutionCost(MAX_COST)
     , NCBucketSize(cost2log2gub(upperBound) + 1)
-    , NCBuckets(NCBucketSize, VariableList(&Store::storeVariable))
-    , PendingSeparator(&Store::storeSeparator)
+    , NCBuckets(NCBucketSize, VariableList(&Store::trail))
+    , PendingSeparator(&Store::trail)
     , objectiveChanged(false)
     , nbNodes(0)
     , nbDEE(0)
@@ -588,6 +638,7 @@ int WCSP::makeIntervalVariable(string n, Value iinf, Value isup)
         cerr << "VAC not implemented on interval variables!" << endl;
         ToulBar2::vac = 0;
         ToulBar2::minsumDiffusion = 0;
+        ToulBar2::trws = 0;
     }
     IntervalVariable* x = new IntervalVariable(this, n, iinf, isup);
     if (maxdomainsize < isup - iinf + 1)
@@ -724,6 +775,113 @@ int WCSP::postTernaryConstraint(int xIndex, int yIndex, int zIndex, vector<Cost>
     return ctr->wcspIndex;
 }
 
+// Adds the costs of a nonzero matrix cost between two distinct Boolean variables (see WCSP::postQuadraticBooleanFunction)
+static void addQuadraticBooleanCosts(Cost* costs, double cost, Double multiplier, bool booldom, bool minimize)
+{
+    Cost c = (Cost)(multiplier * 2. * abs(cost));
+    if (booldom) {
+        if ((cost > 0) == minimize) {
+            costs[3] += c;
+        } else {
+            costs[0] += c;
+            costs[1] += c;
+            costs[2] += c;
+        }
+    } else {
+        if ((cost > 0) == minimize) {
+            costs[0] += c;
+            costs[3] += c;
+        } else {
+            costs[1] += c;
+            costs[2] += c;
+        }
+    }
+}
+
+/// \brief posts the unary and binary cost functions of a quadratic function on Boolean variables \f$ \sum_{e=1}^M W_e \times X_{posx_e} \times X_{posy_e} \f$ (see WCSP::read_qpbo)
+/// \param n number of Boolean variables, already created with indexes 0 to n-1
+/// \param m number of nonzero matrix costs
+/// \param posx first variable indexes of nonzero matrix costs (starting from 1)
+/// \param posy second variable indexes of nonzero matrix costs (starting from 1)
+/// \param cost nonzero matrix costs (multiplied by 2 for distinct variables)
+/// \param multiplier conversion factor from matrix costs to integer costs
+/// \param booldom true if variable domain values are {0,1} else {1,-1}
+/// \param minimize true if the quadratic function is minimized else maximized
+/// \note The sparse matrix is stored by rows (compressed sparse row format) in order to merge all the matrix costs on the same pair of variables, whatever their order, into a single binary cost function.
+/// Binary cost functions are created in the order of the first matrix cost on their pair of variables.
+void WCSP::postQuadraticBooleanFunction(int n, int m, int* posx, int* posy, double* cost, Double multiplier, bool booldom, bool minimize)
+{
+    // sparse matrix rows, the smallest variable index of each matrix cost giving its row
+    vector<int> rowStart(n + 1, 0);
+    for (int e = 0; e < m; e++) {
+        if (posx[e] != posy[e])
+            rowStart[min(posx[e], posy[e])]++; // row size stored after its start
+    }
+    for (int i = 0; i < n; i++)
+        rowStart[i + 1] += rowStart[i];
+    vector<int> rowEdges(rowStart[n]);
+    vector<int> rowNext(rowStart.begin(), rowStart.end() - 1);
+    for (int e = 0; e < m; e++) {
+        if (posx[e] != posy[e])
+            rowEdges[rowNext[min(posx[e], posy[e]) - 1]++] = e;
+    }
+
+    // merges the matrix costs on the same pair of variables into packed cost tables
+    vector<int> pairOf(m, -1);
+    vector<int> pairFirst; // first matrix cost of each pair
+    vector<Cost> pairCosts; // four costs per pair, in the order of its first matrix cost
+    vector<int> rowPair(n, -1); // pair of the current row with a given column
+    for (int i = 0; i < n; i++) {
+        for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+            int e = rowEdges[k];
+            int j = max(posx[e], posy[e]) - 1;
+            if (rowPair[j] < 0) {
+                rowPair[j] = pairFirst.size();
+                pairFirst.push_back(e);
+                pairCosts.resize(pairCosts.size() + 4, MIN_COST);
+            }
+            int p = rowPair[j];
+            pairOf[e] = p;
+            Cost costs[4] = { MIN_COST, MIN_COST, MIN_COST, MIN_COST };
+            addQuadraticBooleanCosts(costs, cost[e], multiplier, booldom, minimize);
+            if (posx[e] != posx[pairFirst[p]])
+                swap(costs[1], costs[2]);
+            for (int t = 0; t < 4; t++)
+                pairCosts[4 * p + t] += costs[t];
+        }
+        for (int k = rowStart[i]; k < rowStart[i + 1]; k++)
+            rowPair[max(posx[rowEdges[k]], posy[rowEdges[k]]) - 1] = -1;
+    }
+
+    vector<Cost> unaryCosts0(n, MIN_COST);
+    vector<Cost> unaryCosts1(n, MIN_COST);
+    for (int e = 0; e < m; e++) {
+        if (posx[e] != posy[e]) {
+            int p = pairOf[e];
+            if (pairFirst[p] == e) {
+                vector<Cost> costs(pairCosts.begin() + 4 * p, pairCosts.begin() + 4 * p + 4);
+                postBinaryConstraint(posx[e] - 1, posy[e] - 1, costs);
+            }
+        } else {
+            Cost c = (Cost)(multiplier * abs(cost[e]));
+            if ((cost[e] > 0) == (minimize == booldom))
+                unaryCosts1[posx[e] - 1] += c;
+            else
+                unaryCosts0[posx[e] - 1] += c;
+        }
+    }
+
+    // create weighted unary clauses
+    for (int i = 0; i < n; i++) {
+        if (unaryCosts0[i] > 0 || unaryCosts1[i] > 0) {
+            vector<Cost> costs(2, 0);
+            costs[0] = unaryCosts0[i];
+            costs[1] = unaryCosts1[i];
+            postUnaryConstraint(i, costs);
+        }
+    }
+}
+
 /// \brief create a global cost function using a default cost (tuples with a different cost will be enter later using WCSP::postNaryConstraintTuple)
 /// \param scopeIndex array of enumerated variable indexes (as returned by makeEnumeratedVariable)
 /// \param arity size of scopeIndex
@@ -751,23 +909,50 @@ int WCSP::postNaryConstraintBegin(int* scopeIndex, int arity, Cost defval, Long
     } else {
         ctr = new NaryConstraint(this, scopeVars, arity, defval, nbtuples);
     }
-    if (arity > NARYPROJECTIONSIZE) {
-        if (isDelayedNaryCtr)
-            delayedNaryCtr.push_back(ctr->wcspIndex);
-        else {
-            BinaryConstraint* bctr;
-            TernaryConstraint* tctr = new TernaryConstraint(this);
-            elimTernConstrs.push_back(tctr);
-            for (int j = 0; j < 3; j++) {
-                if (!ToulBar2::vac)
-                    bctr = new BinaryConstraint(this);
-                else
-                    bctr = new VACBinaryConstraint(this);
-                elimBinConstrs.push_back(bctr);
-            }
+    if (arity > NARYPROJECTIONSIZE)
+        addNaryEliminationSpace(ctr);
+    delete[] scopeVars;
+    return ctr->wcspIndex;
+}
+
+void WCSP::addNaryEliminationSpace(AbstractNaryConstraint* ctr)
+{
+    if (isDelayedNaryCtr)
+        delayedNaryCtr.push_back(ctr->wcspIndex);
+    else {
+        BinaryConstraint* bctr;
+        TernaryConstraint* tctr = new TernaryConstraint(this);
+        elimTernConstrs.push_back(tctr);
+        for (int j = 0; j < 3; j++) {
+            if (!ToulBar2::vac)
+                bctr = new BinaryConstraint(this);
+            else
+                bctr = new VACBinaryConstraint(this);
+            elimBinConstrs.push_back(bctr);
         }
     }
+}
+
+/// \brief create a weighted clause directly (same as WCSP::postNaryConstraintBegin with a single tuple, followed by WCSP::postNaryConstraintTuple and WCSP::postNaryConstraintEnd)
+/// \param scopeIndex array of Boolean variable indexes
+/// \param arity size of scopeIndex (greater than 3)
+/// \param cost weight of the clause
+/// \param forbiddenTuple assignment violating the clause (value indexes plus ::CHAR_FIRST)
+int WCSP::postWeightedClause(int* scopeIndex, int arity, Cost cost, const String& forbiddenTuple)
+{
+    assert(arity > NARYPROJECTIONSIZE);
+    assert((int)forbiddenTuple.size() == arity);
+    EnumeratedVariable** scopeVars = new EnumeratedVariable*[arity];
+    for (int i = 0; i < arity; i++) {
+        scopeVars[i] = (EnumeratedVariable*)vars[scopeIndex[i]];
+        assert(scopeVars[i]->getDomainInitSize() == 2);
+    }
+    WeightedClause* ctr = new WeightedClause(this, scopeVars, arity, cost, forbiddenTuple);
+    addNaryEliminationSpace(ctr);
     delete[] scopeVars;
+    if (ToulBar2::vac)
+        histogram(cost);
+    postNaryConstraintEnd(ctr->wcspIndex);
     return ctr->wcspIndex;
 }
 
@@ -1089,8 +1274,10 @@ GlobalConstraint* WCSP::postGlobalCostFunction(int* scopeIndex, int arity, const
         exit(1);
     }
 
-    if (gc != NULL)
+    if (gc != NULL) {
         globalconstrs.push_back(gc);
+        gc->queuePropagation();
+    }
 
     return gc;
 }
@@ -1930,8 +2117,6 @@ void WCSP::preprocessing()
         propagate();
     }
 
-    if (ToulBar2::minsumDiffusion && ToulBar2::vac)
-        vac->minsumDiffusion();
     if (ToulBar2::vac) {
         if (ToulBar2::verbose >= 1)
             cout << "Preprocessing ";
@@ -2254,7 +2439,7 @@ void WCSP::dump(ostream& os, bool original)
     char Pb_graph[512];
     char Pb_degree[512];
 
-    strcpy(Pb_basename, ToulBar2::problemsaved_filename.c_str());
+    strcpy(Pb_basename, uncompressedName(ToulBar2::problemsaved_filename).c_str());
     strcpy(Pb_graph, Pb_basename);
     strcpy(Pb_degree, Pb_basename);
 
@@ -2487,6 +2672,10 @@ void WCSP::whenContradiction()
     EAC2.clear();
     Eliminate.clear();
     DEE.clear();
+    for (vector<GlobalConstraint*>::iterator it = globalconstrs.begin(); it != globalconstrs.end(); it++) {
+        (*it)->unqueue();
+    }
+    GlobalQueue.clear();
     objectiveChanged = false;
     nbNodes++;
 }
@@ -2625,16 +2814,7 @@ void WCSP::propagateDEE()
         EnumeratedVariable* x = (EnumeratedVariable*)DEE.pop();
         if (x->unassigned()) {
             if (ToulBar2::DEE_ >= 3 || (ToulBar2::DEE_ == 2 && Store::getDepth() == 0)) {
-                for (EnumeratedVariable::iterator itera = x->begin(); itera != x->end(); ++itera) {
-                    for (EnumeratedVariable::iterator iterb = x->lower_bound(*itera + 1); iterb != x->end(); ++iterb) {
-                        assert(x->canbe(*itera));
-                        assert(x->canbe(*iterb));
-                        assert(*itera != *iterb);
-                        x->propagateDEE(*itera, *iterb, false);
-                        if (x->cannotbe(*itera))
-                            break;
-                    }
-                }
+                x->propagateAllDEE();
             } else {
                 Value a = x->getSupport();
                 Value b = x->getMaxCostValue();
@@ -2704,7 +2884,7 @@ void WCSP::eliminate()
 /// -# EAC queue
 /// -# DAC queue
 /// -# AC queue
-/// -# monolithic (flow-based and DAG-based) global cost function propagation (partly incremental)
+/// -# monolithic (flow-based and DAG-based) global cost function propagation, restricted to global cost functions having events on their scope (see WCSP::propagateGlobals)
 /// -# NC queue
 /// -# returns to #1 until all the previous queues are empty
 /// -# DEE queue
@@ -2724,9 +2904,7 @@ void WCSP::propagate()
     if (ToulBar2::vac)
         vac->iniThreshold();
 
-    for (vector<GlobalConstraint*>::iterator it = globalconstrs.begin(); it != globalconstrs.end(); it++) {
-        (*(it))->init();
-    }
+    propagateGlobals();
     if (isGlobal() && ToulBar2::LcLevel >= LC_EDAC) {
         for (unsigned int i = 0; i < vars.size(); i++) {
             EnumeratedVariable* x = (EnumeratedVariable*)vars[i];
@@ -2747,7 +2925,8 @@ void WCSP::propagate()
                                                                                      && !AC.empty())
                         || (ToulBar2::LcLevel >= LC_DAC
                                && !DAC.empty())
-                        || (ToulBar2::LcLevel == LC_EDAC && !CSP(getLb(), getUb()) && !EAC1.empty())) {
+                        || (ToulBar2::LcLevel == LC_EDAC && !CSP(getLb(), getUb()) && !EAC1.empty())
+                        || !GlobalQueue.empty()) {
                         eac_iter++;
                         propagateIncDec();
                         if (ToulBar2::LcLevel == LC_EDAC && !CSP(getLb(), getUb()))
@@ -2765,15 +2944,8 @@ void WCSP::propagate()
                         while (cont) {
                             oldLb = getLb();
                             cont = false;
-                            for (vector<GlobalConstraint*>::iterator it = globalconstrs.begin(); it != globalconstrs.end(); it++) {
-                                if (ToulBar2::interrupted)
-                                    throw TimeOut();
-                                (*(it))->propagate();
-                                if (ToulBar2::LcLevel == LC_SNIC)
-                                    if (!IncDec.empty())
-                                        cont = true; //For detecting value removal during SNIC enforcement
-                                propagateIncDec();
-                            }
+                            if (propagateGlobals() && ToulBar2::LcLevel == LC_SNIC)
+                                cont = true; //For detecting value removal during SNIC enforcement
                             if (ToulBar2::LcLevel == LC_SNIC)
                                 if (!NC.empty() || objectiveChanged)
                                     cont = true; //For detecting value removal and upper bound change
@@ -2814,6 +2986,7 @@ void WCSP::propagate()
             || (ToulBar2::LcLevel >= LC_DAC && !DAC.empty())
             || (ToulBar2::LcLevel == LC_EDAC && !CSP(getLb(), getUb()) && !EAC1.empty())
             || !Eliminate.empty()
+            || !GlobalQueue.empty()
             || (ToulBar2::vac && !CSP(getLb(), getUb()) && !vac->isVAC()));
         // TO BE DONE AFTER NORMAL PROPAGATION
         if (td)
@@ -2822,7 +2995,8 @@ void WCSP::propagate()
     revise(NULL);
 
     for (vector<GlobalConstraint*>::iterator it = globalconstrs.begin(); it != globalconstrs.end(); it++) {
-        (*(it))->end();
+        if ((*(it))->initializedInPropagation())
+            (*(it))->end();
     }
     assert(verify());
     assert(!objectiveChanged);
@@ -2843,6 +3017,32 @@ void WCSP::propagate()
     nbNodes++;
 }
 
+/// \brief propagates global cost functions having events on their scope since their last propagation, by increasing estimated costs of their propagators
+/// \note the structure of a global cost function is initialized at its first propagation during the current call to WCSP::propagate
+/// \note without AC propagation, value removals are not notified to global cost functions, which are all propagated at each call
+bool WCSP::propagateGlobals()
+{
+    for (vector<GlobalConstraint*>::iterator it = globalconstrs.begin(); it != globalconstrs.end(); it++) {
+        if (!(ToulBar2::LcLevel == LC_AC || ToulBar2::LcLevel >= LC_FDAC) || (!(*it)->incremental() && !(*it)->initializedInPropagation()))
+            (*it)->queuePropagation();
+    }
+    if (GlobalQueue.empty())
+        return false;
+    vector<GlobalConstraint*> globals;
+    globals.swap(GlobalQueue);
+    stable_sort(globals.begin(), globals.end(), [](GlobalConstraint* gc1, GlobalConstraint* gc2) { return gc1->getPropagationCost() < gc2->getPropagationCost(); });
+    bool boundEvents = false;
+    for (vector<GlobalConstraint*>::iterator it = globals.begin(); it != globals.end(); it++) {
+        if (ToulBar2::interrupted)
+            throw TimeOut();
+        (*it)->propagateQueued();
+        if (!IncDec.empty())
+            boundEvents = true;
+        propagateIncDec();
+    }
+    return boundEvents;
+}
+
 void WCSP::restoreSolution(Cluster* c)
 {
     int elimo = getElimOrder();
@@ -12,6 +12,7 @@
 #include "tb2enumvar.hpp"
 #include "tb2intervar.hpp"
 
+class AbstractNaryConstraint;
 class NaryConstraint;
 class VACExtension;
 
@@ -57,6 +58,7 @@ class WCSP FINAL : public WeightedCSP {
     Queue Eliminate; ///< Variable Elimination queue (non backtrackable list)
     SeparatorList PendingSeparator; ///< List of pending separators for BTD-like methods (backtrackable list)
     Queue DEE; ///< Dead-End Elimination queue (non backtrackable list)
+    vector<GlobalConstraint*> GlobalQueue; ///< global cost functions having events on their scope since their last propagation (non backtrackable list)
     bool objectiveChanged; ///< flag if lb or ub has changed (NC propagation needs to be done)
     Long nbNodes; ///< current number of calls to propagate method (roughly equal to number of search nodes), used as a time-stamp by Queue methods
     Long nbDEE; ///< number of value removals due to DEE
@@ -109,6 +111,8 @@ public:
     int maxDegree; ///< maximum degree of eliminated variables found in preprocessing
     Long elimSpace; ///< estimate of total space required for generic variable elimination
 
+    void addNaryEliminationSpace(AbstractNaryConstraint* ctr); ///< \brief delays propagation of a new n-ary cost function or reserves cost functions for eliminating its variables
+
     VACExtension* vac; ///< link to VAC management system
 
 #ifdef XMLFLAG
@@ -392,10 +396,12 @@ public:
     int postSpecialDisjunction(int xIndex, int yIndex, Value cstx, Value csty, Value xinfty, Value yinfty, Cost costx, Cost costy);
     int postBinaryConstraint(int xIndex, int yIndex, vector<Cost>& costs);
     int postTernaryConstraint(int xIndex, int yIndex, int zIndex, vector<Cost>& costs);
+    void postQuadraticBooleanFunction(int n, int m, int* posx, int* posy, double* cost, Double multiplier, bool booldom, bool minimize);
     int postNaryConstraintBegin(int* scopeIndex, int arity, Cost defval, Long nbtuples = 0); /// \warning must call postNaryConstraintEnd after giving cost tuples ; \warning it may create a WeightedClause instead of NaryConstraint
     void postNaryConstraintTuple(int ctrindex, Value* tuple, int arity, Cost cost);
     void postNaryConstraintTuple(int ctrindex, const String& tuple, Cost cost);
     void postNaryConstraintEnd(int ctrindex);
+    int postWeightedClause(int* scopeIndex, int arity, Cost cost, const String& forbiddenTuple); ///< \brief create and propagate a weighted clause on Boolean variables of arity greater than 3 \param forbiddenTuple negation of the clause (String encoding of value indexes)
 
     int postCliqueConstraint(int* scopeIndex, int arity, istream& file);
 
@@ -439,6 +445,7 @@ public:
     void read_random(int n, int m, vector<int>& p, int seed, bool forceSubModular = false, string globalname = ""); ///< \brief create a random WCSP with \e n variables, domain size \e m, array \e p where the first element is a percentage of tuples with a nonzero cost and next elements are the number of random cost functions for each different arity (starting with arity two), random seed, a flag to have a percentage (last element in the array \e p) of the binary cost functions being permutated submodular, and a string to use a specific global cost function instead of random cost functions in extension
     void read_wcnf(const char* fileName); ///< \brief load problem in (w)cnf format (see http://www.maxsat.udl.cat/08/index.php?disp=requirements)
     void read_qpbo(const char* fileName); ///< \brief load quadratic pseudo-Boolean optimization problem in unconstrained quadratic programming text format (first text line with n, number of variables and m, number of triplets, followed by the m triplets (x,y,cost) describing the sparse symmetric nXn cost matrix with variable indexes such that x <= y and any positive or negative real numbers for costs)
+    void read_wcspbin(const char* fileName); ///< \brief load problem from a binary snapshot file (see \ref wcspbinformat), mapping it in memory without parsing
 
     void read_XML(const char* fileName); ///< \brief load problem in XML format (see http://www.cril.univ-artois.fr/~lecoutre/benchmarks.html)
     void solution_XML(bool opt = false); ///< \brief output solution in Max-CSP 2008 output format
@@ -483,6 +490,8 @@ public:
 
     void print(ostream& os); ///< \brief print current domains and active cost functions (see \ref verbosity)
     void dump(ostream& os, bool original = true); ///< \brief output the current WCSP into a file in wcsp format \param os output file \param original if true then keeps all variables with their original domain size else uses unassigned variables and current domains recoding variable indexes
+    void dump_wcspbin(const char* fileName, bool original = true); ///< \brief output the current WCSP into a binary snapshot file (see \ref wcspbinformat) \param fileName output file name \param original if true then keeps all variables with their original domain size else uses unassigned variables and current domains recoding variable indexes
+    Cost miniBucketElimination(vector<int>& varIndexes, vector<Value>& values); ///< \brief mini-bucket elimination of the current problem (see \ref minibucket) \param varIndexes (output) variable indexes of a greedy solution (empty if none) \param values (output) values of the greedy solution \return lower bound of the optimum
     friend ostream& operator<<(ostream& os, WCSP& wcsp); ///< \relates WCSP::print
 
     // -----------------------------------------------------------
@@ -538,6 +547,7 @@ public:
     void queueSeparator(DLink<Separator*>* link) { PendingSeparator.push_back(link, true); }
     void unqueueSeparator(DLink<Separator*>* link) { PendingSeparator.erase(link, true); }
     void queueDEE(DLink<VariableWithTimeStamp>* link) { DEE.push(link, nbNodes); }
+    void queueGlobal(GlobalConstraint* gc) { GlobalQueue.push_back(gc); }
 
     void propagateNC(); ///< \brief removes forbidden values
     void propagateIncDec(); ///< \brief ensures unary bound arc consistency supports (remove forbidden domain bounds)
@@ -548,6 +558,7 @@ public:
     void propagateEAC(); ///< \brief ensures unary existential arc consistency supports
     void propagateSeparator(); ///< \brief exploits graph-based learning
     void propagateDEE(); ///< \brief removes dominated values (dead-end elimination and possibly soft neighborhood substitutability)
+    bool propagateGlobals(); ///< \brief propagates queued global cost functions, cheapest propagators first (returns true if bound events were produced)
 
     /// \brief sorts the list of constraints associated to each variable based on smallest problem variable indexes
     /// \warning side-effect: updates DAC order according to an existing variable elimination order
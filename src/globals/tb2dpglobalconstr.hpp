@@ -46,6 +46,9 @@ protected:
     //EAC
     virtual bool isEAC(int var, Value val);
     virtual void findFullSupportEAC(int var);
+
+public:
+    GlobalPropagationCost getPropagationCost() const { return DP_PROPAGATION; }
 };
 
 #endif //TB2GLOBALCONSTR3_HPP_
@@ -88,6 +88,7 @@ public:
     virtual void organizeConfig() {}
     virtual void initStructure();
     virtual void end() {}
+    GlobalPropagationCost getPropagationCost() const { return FLOW_PROPAGATION; }
 
     //void propagate();
 
@@ -5,6 +5,8 @@
 
 GlobalConstraint::GlobalConstraint(WCSP* wcsp, EnumeratedVariable** scope_in, int arity_in, Cost defval)
     : AbstractGlobalConstraint(wcsp, scope_in, arity_in)
+    , queued(false)
+    , initNode(-1)
     , extendedCost(NULL)
     , projectedCost(0)
     , nonassigned(arity_in)
@@ -46,6 +48,7 @@ void GlobalConstraint::init()
 {
     if (deconnected())
         return;
+    initNode = wcsp->getNbNodes();
     needPropagateAC = true;
     needPropagateDAC = true;
     needPropagateEAC = false;
@@ -137,6 +140,7 @@ void GlobalConstraint::assign(int varIndex)
             projectLB(eval(t));
         } else {
             pushAll();
+            queuePropagation();
         }
     }
 }
@@ -175,6 +179,7 @@ void GlobalConstraint::remove(int index)
     currentVar = -1;
     needPropagateDAC = true;
     needPropagateAC = true;
+    queuePropagation();
 }
 
 void GlobalConstraint::projectFromZero(int index)
@@ -182,6 +187,7 @@ void GlobalConstraint::projectFromZero(int index)
     //vector<int> rmv;
     currentVar = -1;
     needPropagateDAC = true;
+    queuePropagation();
 }
 
 void GlobalConstraint::propagate()
@@ -19,7 +19,16 @@ public:
     virtual void addTransition(int start, int symbol, int end, int weight) = 0;
 };
 
+/// estimated cost of the propagator of a global cost function (cheapest propagators are run first, see WCSP::propagateGlobals)
+enum GlobalPropagationCost {
+    DP_PROPAGATION, ///< dynamic programming over the scope
+    FLOW_PROPAGATION, ///< minimum cost flow
+    MIP_PROPAGATION ///< linear programming
+};
+
 class GlobalConstraint : public AbstractGlobalConstraint {
+    bool queued; // true if waiting in the queue of global cost functions (see WCSP::queueGlobal)
+    Long initNode; // value of WCSP::nbNodes when init was last called
 
 protected:
     vector<StoreCost>* deltaCost; // the cost transferred from/to nary-constraint, must be backtractable
@@ -101,6 +110,28 @@ public:
 
     // initialize the constraint structure for enforing consistency
     void init();
+    /// \brief queues the constraint for propagation (after an event on its scope)
+    void queuePropagation()
+    {
+        if (!queued) {
+            queued = true;
+            wcsp->queueGlobal(this);
+        }
+    }
+    void unqueue() { queued = false; }
+    /// \brief propagates the events received since the last propagation, initializing the constraint structure first if not done during the current call to WCSP::propagate
+    void propagateQueued()
+    {
+        unqueue();
+        if (initNode != wcsp->getNbNodes())
+            init();
+        else
+            propagate();
+    }
+    bool initializedInPropagation() const { return initNode == wcsp->getNbNodes(); } ///< \brief true if init was called during the current call to WCSP::propagate
+    virtual GlobalPropagationCost getPropagationCost() const = 0;
+    /// \brief false if the constraint structure is not backtrackable and must be initialized at each call to WCSP::propagate
+    virtual bool incremental() const { return true; }
     virtual void initStructure() {}
     // clear up the structure
     virtual void end() {}
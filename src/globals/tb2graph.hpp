@@ -72,7 +72,7 @@ public:
     typedef typename BTList<T>::iterator iterator;
 
     BTListWrapper(DLinkStore<int>* dlinkStore)
-        : list(&Store::storeIndexList)
+        : list(&Store::trail)
         , dlinkStore(dlinkStore)
     {
     }
@@ -85,6 +85,8 @@ public:
     virtual void read(istream& file, bool mult = true) {}
     virtual void initStructure();
     virtual void end();
+    GlobalPropagationCost getPropagationCost() const { return MIP_PROPAGATION; }
+    bool incremental() const { return false; } // the MIP is built again at each initialization
 
     unsigned called_time();
 };
@@ -0,0 +1,297 @@
+/*
+ * **************** Parallel Hybrid Best-First Search *******************
+ *
+ */
+
+#include "tb2parallelhbfs.hpp"
+#include "core/tb2domain.hpp"
+#include "tb2portfolio.hpp"
+
+#ifdef LINUX
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+SharedOpenList::SharedOpenList(int nbWorkers, size_t maxOpen, size_t maxCP)
+    : header(NULL)
+    , size(0)
+    , working(NULL)
+    , heap(NULL)
+    , arena(NULL)
+{
+    size = sizeof(Header) + nbWorkers * sizeof(Cost) + maxOpen * sizeof(Solver::OpenNode) + maxCP * sizeof(Solver::ChoicePoint);
+#ifdef LINUX
+    void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0); // pages are allocated only when used
+    if (mem == MAP_FAILED) {
+        cerr << "Error: cannot allocate shared memory for parallel hybrid best-first search!" << endl;
+        exit(EXIT_FAILURE);
+    }
+#else
+    void* mem = malloc(size);
+#endif
+    header = (Header*)mem;
+    working = (Cost*)(header + 1);
+    heap = (Solver::OpenNode*)(working + nbWorkers);
+    arena = (Solver::ChoicePoint*)(heap + maxOpen);
+    header->lock = 0;
+    header->busy = 0;
+    header->done = 0;
+    header->nbWorkers = nbWorkers;
+    header->lb = MIN_COST;
+    header->nbNodes = 0;
+    header->nbBacktracks = 0;
+    header->nbRecomputationNodes = 0;
+    header->nbOpen = 0;
+    header->maxOpen = maxOpen;
+    header->nbCP = 0;
+    header->maxCP = maxCP;
+    for (int w = 0; w < nbWorkers; w++)
+        working[w] = MAX_COST;
+}
+
+SharedOpenList::~SharedOpenList()
+{
+#ifdef LINUX
+    munmap(header, size);
+#else
+    free(header);
+#endif
+}
+
+void SharedOpenList::lock()
+{
+    while (__sync_lock_test_and_set(&header->lock, 1))
+        while (header->lock)
+            ;
+}
+
+void SharedOpenList::unlock()
+{
+    __sync_lock_release(&header->lock);
+}
+
+void SharedOpenList::init(Cost lb)
+{
+    header->lb = lb;
+    heap[0] = Solver::OpenNode(lb, 0, 0, 0);
+    header->nbOpen = 1;
+}
+
+Cost SharedOpenList::globalLb(Cost ub) const
+{
+    Cost lb = ((header->nbOpen > 0) ? heap[0].getCost() : ub);
+    for (int w = 0; w < header->nbWorkers; w++)
+        lb = MIN(lb, working[w]);
+    return MIN(lb, ub);
+}
+
+bool SharedOpenList::pop(int worker, Cost ub, Solver::CPStore& cp, Solver::OpenNode& nd)
+{
+    lock();
+    if (header->done || (header->nbOpen > 0 && CUT(heap[0].getCost(), ub))) {
+        header->nbOpen = 0; // all remaining open nodes are useless
+    }
+    if (header->nbOpen == 0) {
+        header->nbCP = 0; // choice points are no more referenced by any shared open node
+        if (header->busy == 0 && !header->done)
+            header->done = 1;
+        unlock();
+        return false;
+    }
+    pop_heap(heap, heap + header->nbOpen);
+    header->nbOpen--;
+    nd = heap[header->nbOpen];
+    cp.clear();
+    cp.insert(cp.end(), arena + nd.first, arena + nd.last);
+    working[worker] = nd.getCost();
+    header->busy++;
+    unlock();
+
+    nd = Solver::OpenNode(nd.getCost(), 0, cp.size(), cp.size());
+    cp.start = 0;
+    cp.stop = cp.size();
+    cp.store();
+    return true;
+}
+
+bool SharedOpenList::push(int worker, Solver::CPStore& cp, Solver::OpenList& open, Cost ub)
+{
+    assert(cp.start <= cp.stop && (size_t)cp.stop <= cp.size());
+    // open nodes of the current region share the restored branch as a prefix which must be copied first
+    vector<Solver::ChoicePoint> prefix;
+    if (!open.empty())
+        cp.getPrefix(prefix);
+    ptrdiff_t nbcp = ((open.empty()) ? 0 : (prefix.size() + cp.stop - cp.start));
+    lock();
+    if (header->nbCP + nbcp > header->maxCP || header->nbOpen + open.size() > header->maxOpen) {
+        unlock();
+        return false;
+    }
+    ptrdiff_t base = header->nbCP;
+    if (nbcp > 0) {
+        copy(prefix.begin(), prefix.end(), arena + base);
+        copy(cp.begin() + cp.start, cp.begin() + cp.stop, arena + base + prefix.size());
+        header->nbCP += nbcp;
+    }
+    while (!open.empty()) {
+        Solver::OpenNode nd = open.top();
+        open.pop();
+        if (CUT(nd.getCost(), ub))
+            break; // next open nodes are also useless
+        assert(nd.first == cp.start && nd.last <= cp.stop);
+        heap[header->nbOpen] = Solver::OpenNode(nd.getCost(), base, base + prefix.size() + nd.last - cp.start, nd.depth);
+        header->nbOpen++;
+        push_heap(heap, heap + header->nbOpen);
+    }
+    working[worker] = MAX_COST;
+    header->busy--;
+    unlock();
+    open = Solver::OpenList();
+    return true;
+}
+
+bool SharedOpenList::improveLb(Cost ub, Cost& lb)
+{
+    bool improved = false;
+    lock();
+    Cost newlb = globalLb(ub);
+    if (newlb > header->lb) {
+        header->lb = newlb;
+        improved = true;
+    }
+    lb = header->lb;
+    unlock();
+    return improved;
+}
+
+void SharedOpenList::addStatistics(Long nodes, Long backtracks, Long recomputations)
+{
+    lock();
+    header->nbNodes += nodes;
+    header->nbBacktracks += backtracks;
+    header->nbRecomputationNodes += recomputations;
+    unlock();
+}
+
+static SharedOpenList* sharedOpenList = NULL; // shared list of the current worker process
+static externalfunc previousTimeOut = NULL;
+
+static void parallelHybridTimeOut()
+{
+    if (sharedOpenList)
+        sharedOpenList->interrupt(); // stop idle workers
+    if (previousTimeOut)
+        (*previousTimeOut)();
+    else
+        exit(0);
+}
+
+pair<Cost, Cost> Solver::parallelHybridSolve()
+{
+    Cost clb = wcsp->getLb();
+    Cost cub = wcsp->getUb();
+    assert(clb < cub);
+    SharedOpenList shared(ToulBar2::hbfsWorkers, min((size_t)ToulBar2::hbfsOpenNodeLimit, PARALLEL_OPEN_NODE_LIMIT), min((size_t)ToulBar2::hbfsCPLimit, PARALLEL_CHOICE_POINT_LIMIT));
+    shared.init(clb);
+    Portfolio::share(wcsp);
+    if (ToulBar2::verbose >= 0)
+        cout << "Parallel hybrid best-first search with " << ToulBar2::hbfsWorkers << " workers." << endl;
+    nbHybrid++;
+    nbHybridNew++;
+
+    if (Portfolio::spawn(ToulBar2::hbfsWorkers)) {
+        // main process: all workers are done
+        Portfolio::collect(wcsp);
+        nbNodes += shared.getNbNodes();
+        nbBacktracks += shared.getNbBacktracks();
+        nbRecomputationNodes += shared.getNbRecomputationNodes();
+        ToulBar2::limited = (!shared.finished() || shared.interrupted());
+        cub = wcsp->getUb();
+        clb = ((ToulBar2::limited) ? MIN(shared.getLb(), cub) : cub);
+        return make_pair(clb, cub);
+    }
+
+    // worker process
+    int worker = Portfolio::getWorker();
+    sharedOpenList = &shared;
+    previousTimeOut = ToulBar2::timeOut;
+    ToulBar2::timeOut = parallelHybridTimeOut;
+    Long initialNbNodes = nbNodes;
+    Long initialNbBacktracks = nbBacktracks;
+    Long initialNbRecomputationNodes = nbRecomputationNodes;
+    if (cp != NULL)
+        delete cp;
+    cp = new CPStore();
+    if (open != NULL)
+        delete open;
+    open = new OpenList();
+    OpenNode nd(MAX_COST, 0, 0, 0);
+    while (true) {
+        wcsp->updateUb(Portfolio::getUb());
+        cub = wcsp->getUb();
+        if (!shared.pop(worker, cub, *cp, nd)) {
+            if (shared.finished())
+                break;
+#ifdef LINUX
+            usleep(100); // wait for new open nodes
+#endif
+            continue;
+        }
+        hbfsLimit = ((ToulBar2::hbfs > 0) ? (nbBacktracks + ToulBar2::hbfs) : LONGLONG_MAX);
+        int storedepthBFS = Store::getDepth();
+        try {
+            Store::store();
+            restore(*cp, nd);
+            recursiveSolve(MAX(nd.getCost(), wcsp->getLb()));
+        } catch (Contradiction) {
+            wcsp->whenContradiction();
+        }
+        Store::restore(storedepthBFS);
+        cub = wcsp->getUb();
+        if (!shared.push(worker, *cp, *open, cub)) {
+            // not enough shared memory: explore remaining open nodes of this worker by depth-first search
+            ToulBar2::hbfs = 0;
+            ToulBar2::hbfsGlobalLimit = 0;
+            hbfsLimit = LONGLONG_MAX;
+            while (!open->empty()) {
+                OpenNode local = open->top();
+                open->pop();
+                if (CUT(local.getCost(), wcsp->getUb()))
+                    continue;
+                cp->store();
+                try {
+                    Store::store();
+                    restore(*cp, local);
+                    recursiveSolve(MAX(local.getCost(), wcsp->getLb()));
+                } catch (Contradiction) {
+                    wcsp->whenContradiction();
+                }
+                Store::restore(storedepthBFS);
+            }
+            cub = wcsp->getUb();
+            shared.push(worker, *cp, *open, cub);
+        }
+        Cost lb = MIN_COST;
+        if (shared.improveLb(cub, lb))
+            showGap(lb, cub);
+        if (ToulBar2::hbfs && nbRecomputationNodes > 0) { // adapt the backtrack limit of this worker
+            assert(nbNodes > 0);
+            if (nbRecomputationNodes > nbNodes / ToulBar2::hbfsBeta && ToulBar2::hbfs <= ToulBar2::hbfsGlobalLimit)
+                ToulBar2::hbfs *= 2;
+            else if (nbRecomputationNodes < nbNodes / ToulBar2::hbfsAlpha && ToulBar2::hbfs >= 2)
+                ToulBar2::hbfs /= 2;
+            if (ToulBar2::debug >= 2)
+                cout << "HBFS backtrack limit of worker " << worker << ": " << ToulBar2::hbfs << endl;
+        }
+    }
+    shared.addStatistics(nbNodes - initialNbNodes, nbBacktracks - initialNbBacktracks, nbRecomputationNodes - initialNbRecomputationNodes);
+    cout.flush();
+    _exit(EXIT_SUCCESS); // the main process reports the optimum
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -0,0 +1,86 @@
+/** \file tb2parallelhbfs.hpp
+ *  \brief Open node list shared by parallel hybrid best-first search workers.
+ *
+ *  After preprocessing, ToulBar2::hbfsWorkers worker processes are forked (see Portfolio::spawn), all of them starting from the same root node.
+ *  Each worker repeatedly takes the open node with the smallest lower bound from a shared heap, replays its choice points on its private copy of the problem,
+ *  explores it with its own backtrack limit (as in Solver::hybridSolve), and pushes its new open nodes back.
+ *  The choice points of a worker region, preceded by the restored branch it shares as a prefix, are copied once into a shared append-only arena,
+ *  keeping the compact encoding of Solver::CPStore (open nodes of the same region share their common prefix).
+ *  The global lower bound is the minimum of the heap top and the lower bounds of the nodes currently explored.
+ *  The global upper bound and its solution are shared by Portfolio.
+ *
+ *  \warning When the shared arena or heap is full, a worker explores its remaining open nodes by depth-first search (as when ToulBar2::hbfsCPLimit is reached in sequential search).
+ */
+
+#ifndef TB2PARALLELHBFS_HPP_
+#define TB2PARALLELHBFS_HPP_
+
+#include "tb2solver.hpp"
+
+const size_t PARALLEL_OPEN_NODE_LIMIT = (1 << 22); // default capacity of the shared heap of open nodes
+const size_t PARALLEL_CHOICE_POINT_LIMIT = (1 << 24); // default capacity of the shared arena of choice points
+
+class SharedOpenList {
+    struct Header {
+        volatile int lock; // spinlock protecting the whole shared list
+        volatile int busy; // number of workers exploring an open node
+        volatile int done; // 1 if search is finished, 2 if interrupted by a time limit
+        int nbWorkers;
+        Cost lb; // best global lower bound reported so far
+        Long nbNodes; // search statistics summed over all finished workers
+        Long nbBacktracks;
+        Long nbRecomputationNodes;
+        size_t nbOpen; // number of open nodes in the heap
+        size_t maxOpen;
+        ptrdiff_t nbCP; // number of choice points used in the arena
+        ptrdiff_t maxCP;
+    };
+
+    Header* header;
+    size_t size;
+    Cost* working; // lower bound of the open node explored by each worker (MAX_COST if idle)
+    Solver::OpenNode* heap;
+    Solver::ChoicePoint* arena;
+
+    void lock();
+    void unlock();
+    Cost globalLb(Cost ub) const; ///< \warning must be called with the lock
+
+public:
+    SharedOpenList(int nbWorkers, size_t maxOpen, size_t maxCP);
+    ~SharedOpenList();
+
+    /// \brief inserts the root node
+    void init(Cost lb);
+
+    /// \brief takes the open node with the smallest lower bound and copies its choice points at the beginning of \a cp
+    /// \return false if no open node is available yet (see SharedOpenList::finished to know if search is over)
+    /// \note open nodes greater than or equal to \a ub are discarded
+    bool pop(int worker, Cost ub, Solver::CPStore& cp, Solver::OpenNode& nd);
+
+    /// \brief moves all open nodes of \a open lower than \a ub and their choice points into the shared list and makes the worker idle
+    /// \return false, leaving everything unchanged, if there is not enough room
+    bool push(int worker, Solver::CPStore& cp, Solver::OpenList& open, Cost ub);
+
+    bool finished() const { return header->done != 0; }
+    bool interrupted() const { return header->done == 2; }
+    void interrupt() { header->done = 2; }
+
+    /// \brief returns true if global lower bound has been improved since last call (\a lb being updated)
+    bool improveLb(Cost ub, Cost& lb);
+    Cost getLb() const { return header->lb; }
+
+    void addStatistics(Long nodes, Long backtracks, Long recomputations);
+    Long getNbNodes() const { return header->nbNodes; }
+    Long getNbBacktracks() const { return header->nbBacktracks; }
+    Long getNbRecomputationNodes() const { return header->nbRecomputationNodes; }
+};
+
+#endif /*TB2PARALLELHBFS_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -0,0 +1,256 @@
+/*
+ * **************** Portfolio of racing solvers *******************
+ *
+ */
+
+#include "tb2portfolio.hpp"
+#include "core/tb2wcsp.hpp"
+
+#ifdef LINUX
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/time.h>
+#endif
+
+Portfolio::Shared* Portfolio::shared = NULL;
+size_t Portfolio::sharedSize = 0;
+int Portfolio::worker = -1;
+int Portfolio::lastVersion = 0;
+Cost Portfolio::lastUb = MAX_COST;
+
+void Portfolio::lock()
+{
+    while (__sync_lock_test_and_set(&shared->lock, 1))
+        while (shared->lock)
+            ;
+}
+
+void Portfolio::unlock()
+{
+    __sync_lock_release(&shared->lock);
+}
+
+void Portfolio::configure(int w)
+{
+    if (w == 0)
+        return; // keep command-line configuration
+    ToulBar2::seed += w;
+    switch (w % 4) {
+    case 1: // swap hybrid best-first search and depth-first search
+        if (ToulBar2::hbfs) {
+            ToulBar2::hbfs = 0;
+            ToulBar2::hbfsGlobalLimit = 0;
+        } else if (ToulBar2::binaryBranching && ToulBar2::dichotomicBranching < 2) {
+            ToulBar2::hbfs = 1;
+            ToulBar2::hbfsGlobalLimit = 10000;
+        }
+        break;
+    case 2: // limited discrepancy search
+        ToulBar2::lds = 4;
+        ToulBar2::hbfs = 0;
+        ToulBar2::hbfsGlobalLimit = 0;
+        break;
+    case 3: // randomized search with restarts
+        ToulBar2::restart = 10000;
+        ToulBar2::hbfs = 0;
+        ToulBar2::hbfsGlobalLimit = 0;
+        break;
+    default: // swap VAC during search and VAC in preprocessing only (VAC must have been selected before reading the problem)
+        if (ToulBar2::vac > 1)
+            ToulBar2::vac = 1;
+        else if (ToulBar2::vac == 1)
+            ToulBar2::vac = 100;
+        ToulBar2::restart = 10000; // diversify variable ordering with the seed
+        break;
+    }
+    if (w >= 4 && ToulBar2::restart < 0)
+        ToulBar2::restart = 10000;
+}
+
+void Portfolio::share(WeightedCSP* wcsp)
+{
+#ifdef LINUX
+    sharedSize = sizeof(Shared) + wcsp->numberOfVariables() * sizeof(Value);
+    void* mem = mmap(NULL, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        cerr << "Error: cannot allocate shared memory for parallel search!" << endl;
+        exit(EXIT_FAILURE);
+    }
+    shared = (Shared*)mem;
+    shared->lock = 0;
+    shared->version = 0;
+    shared->winner = -1;
+    shared->owner = -1;
+    shared->ub = wcsp->getUb();
+    lastVersion = 0;
+    lastUb = shared->ub;
+#endif
+}
+
+#ifdef LINUX
+bool Portfolio::spawn(int nbWorkers)
+{
+    assert(shared);
+    struct itimerval left; // remaining time limit of the main process
+    getitimer(ITIMER_VIRTUAL, &left);
+
+    cout.flush();
+    pid_t parent = getpid();
+    vector<pid_t> workers(nbWorkers, 0);
+    for (int w = 0; w < nbWorkers; w++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            cerr << "Error: cannot fork worker " << w << "!" << endl;
+            for (int i = 0; i < w; i++)
+                kill(workers[i], SIGKILL);
+            exit(EXIT_FAILURE);
+        }
+        if (pid == 0) {
+            prctl(PR_SET_PDEATHSIG, SIGKILL); // do not survive the main process
+            if (getppid() != parent)
+                _exit(EXIT_FAILURE);
+            worker = w;
+            // best solutions are written by the main process only
+            ToulBar2::solutionFile = NULL;
+            ToulBar2::solution_uai_file = NULL;
+            if (left.it_value.tv_sec > 0 || left.it_value.tv_usec > 0)
+                timer(left.it_value.tv_sec + ((left.it_value.tv_usec > 0) ? 1 : 0)); // interval timers are not inherited
+            return false;
+        }
+        workers[w] = pid;
+    }
+
+    int running = nbWorkers;
+    while (running > 0) {
+        int status = 0;
+        pid_t pid = wait(&status);
+        if (pid < 0)
+            break;
+        for (int w = 0; w < nbWorkers; w++) {
+            if (workers[w] == pid) {
+                workers[w] = 0;
+                running--;
+            }
+        }
+        if (shared->winner >= 0) {
+            for (int w = 0; w < nbWorkers; w++) {
+                if (workers[w] > 0 && w != shared->winner) // let the winner report its optimum
+                    kill(workers[w], SIGKILL);
+            }
+        }
+    }
+    return true;
+}
+#else
+bool Portfolio::spawn(int nbWorkers)
+{
+    cerr << "Error: parallel search is only available on Linux." << endl;
+    exit(EXIT_FAILURE);
+}
+#endif
+
+bool Portfolio::start(WeightedCSPSolver* solver)
+{
+#ifdef LINUX
+    share(solver->getWCSP());
+    if (spawn(ToulBar2::portfolio))
+        return true;
+    configure(worker);
+    mysrand(ToulBar2::seed);
+    if (ToulBar2::verbose >= 0)
+        cout << "c portfolio worker " << worker << " (pid " << getpid() << "): seed=" << ToulBar2::seed << " hbfs=" << ToulBar2::hbfs << " lds=" << ToulBar2::lds << " restart=" << ToulBar2::restart << " vac=" << ToulBar2::vac << endl;
+#else
+    cout << "Warning! Portfolio search is only available on Linux." << endl;
+    ToulBar2::portfolio = 0;
+#endif
+    return false;
+}
+
+void Portfolio::collect(WeightedCSP* wcsp)
+{
+    if (shared->owner < 0)
+        return;
+    TAssign sol;
+    for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++)
+        sol[i] = shared->solution[i];
+    wcsp->updateUb(shared->ub);
+    wcsp->setSolution(shared->ub, &sol);
+    if (ToulBar2::solutionFile != NULL) {
+        rewind(ToulBar2::solutionFile);
+        wcsp->printSolution(ToulBar2::solutionFile);
+        fprintf(ToulBar2::solutionFile, "\n");
+    }
+    ((WCSP*)wcsp)->solution_UAI(shared->ub);
+}
+
+void Portfolio::end(WeightedCSPSolver* solver)
+{
+    WeightedCSP* wcsp = solver->getWCSP();
+    collect(wcsp);
+    if (ToulBar2::verbose >= 0) {
+        cout << "Portfolio: ";
+        if (shared->winner >= 0)
+            cout << "search completed by worker " << shared->winner;
+        else
+            cout << "no worker completed its search";
+        if (shared->owner >= 0)
+            cout << ", best solution cost " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->Cost2ADCost(shared->ub) << std::setprecision(DECIMAL_POINT) << " found by worker " << shared->owner;
+        else
+            cout << ", no solution found";
+        cout << " in " << cpuTime() - ToulBar2::startCpuTime << " seconds (main process)." << endl;
+    }
+    ToulBar2::limited = (shared->winner < 0);
+}
+
+void Portfolio::publish(WeightedCSP* wcsp, Cost cost)
+{
+    assert(worker >= 0);
+    lock();
+    if (cost < shared->ub) {
+        for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++)
+            shared->solution[i] = wcsp->getValue(i);
+        shared->ub = cost;
+        shared->owner = worker;
+        __sync_fetch_and_add(&shared->version, 1);
+    }
+    lastVersion = shared->version;
+    lastUb = shared->ub;
+    unlock();
+}
+
+void Portfolio::readUb()
+{
+    lock();
+    lastVersion = shared->version;
+    lastUb = shared->ub;
+    unlock();
+}
+
+void Portfolio::retrieve(WeightedCSP* wcsp)
+{
+    Cost cost = MAX_COST;
+    wcsp->getSolution(&cost);
+    lock();
+    if (shared->owner >= 0 && shared->owner != worker && shared->ub < cost) {
+        TAssign sol;
+        for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++)
+            sol[i] = shared->solution[i];
+        wcsp->setSolution(shared->ub, &sol);
+    }
+    unlock();
+}
+
+void Portfolio::finish()
+{
+    __sync_bool_compare_and_swap(&shared->winner, -1, worker);
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
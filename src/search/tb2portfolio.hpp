@@ -0,0 +1,94 @@
+/** \file tb2portfolio.hpp
+ *  \brief Portfolio of differently-configured solvers racing on the same problem.
+ *
+ *  The problem is read and closed once, then ToulBar2::portfolio worker processes are forked.
+ *  Each worker owns a private copy (copy-on-write pages) of the WCSP, its Solver and all Store trailing stacks,
+ *  and runs with its own search configuration (see Portfolio::configure).
+ *  Workers share their best upper bound and its solution through an anonymous shared memory segment.
+ *  The first worker that completes its search proves optimality of the shared upper bound and stops the others.
+ *
+ *  The same shared memory segment and worker processes are also used by parallel hybrid best-first search (see SharedOpenList).
+ *
+ *  \note Workers are processes and not threads because every option and every trailing stack is a static member (see ToulBar2 and Store).
+ *  \warning Only available on Linux (\c LINUX compilation flag).
+ */
+
+#ifndef TB2PORTFOLIO_HPP_
+#define TB2PORTFOLIO_HPP_
+
+#include "toulbar2lib.hpp"
+
+class Portfolio {
+    struct Shared {
+        volatile int lock; // spinlock protecting ub, owner and solution
+        volatile int version; // incremented each time a better solution is published
+        volatile int winner; // first worker having completed its search (-1 if none)
+        int owner; // worker having found the best solution (-1 if none)
+        Cost ub; // best solution cost found by any worker
+        Value solution[1]; // best solution found by any worker (numberOfVariables values)
+    };
+
+    static Shared* shared;
+    static size_t sharedSize;
+    static int worker; // current worker index (-1 in the main process)
+    static int lastVersion; // last shared version seen by the current worker
+    static Cost lastUb; // shared upper bound read at lastVersion
+
+    static void lock();
+    static void unlock();
+
+protected:
+    virtual ~Portfolio() = 0; // Trick to avoid any instantiation of Portfolio
+
+public:
+    static int getWorker() { return worker; }
+
+    /// \brief changes ToulBar2 search options depending on the worker index (worker 0 keeps command-line options)
+    static void configure(int worker);
+
+    /// \brief allocates the shared upper bound and solution (must be called before Portfolio::spawn)
+    static void share(WeightedCSP* wcsp);
+
+    /// \brief forks workers (each one restarting the remaining time limit of the main process) and waits until they are all done
+    /// \return false inside a worker process and true in the main process
+    /// \note as soon as a worker has called Portfolio::finish, all the other workers are killed
+    static bool spawn(int nbWorkers);
+
+    /// \brief forks ToulBar2::portfolio workers solving the same problem and waits until the first one completes its search
+    /// \return false inside a worker process (which must call WeightedCSPSolver::solve and exit) and true in the main process when all workers are done
+    static bool start(WeightedCSPSolver* solver);
+
+    /// \brief copies best shared solution into the main process (and writes solution files)
+    static void collect(WeightedCSP* wcsp);
+
+    /// \brief reports best solution in the main process after all workers are done
+    static void end(WeightedCSPSolver* solver);
+
+    /// \brief shares a new solution found by the current worker (WCSP::getValue must be valid for all variables)
+    static void publish(WeightedCSP* wcsp, Cost cost);
+
+    /// \brief returns best upper bound found by all workers
+    /// \note fast path reads a single shared integer when no new solution has been published since last call
+    static Cost getUb()
+    {
+        if (shared->version != lastVersion)
+            readUb();
+        return lastUb;
+    }
+    static void readUb();
+
+    /// \brief replaces current worker's best solution by the shared one if better (before reporting the optimum)
+    static void retrieve(WeightedCSP* wcsp);
+
+    /// \brief records that current worker has completed its search
+    static void finish();
+};
+
+#endif /*TB2PORTFOLIO_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -5,10 +5,13 @@
 
 #include "tb2solver.hpp"
 #include "core/tb2domain.hpp"
+#include "core/tb2vac.hpp"
 #include "applis/tb2pedigree.hpp"
 #include "applis/tb2haplotype.hpp"
 #include "applis/tb2bep.hpp"
 #include "tb2clusters.hpp"
+#include "tb2portfolio.hpp"
+#include "utils/tb2compression.hpp"
 #include "vns/tb2vnsutils.hpp"
 #include "vns/tb2dgvns.hpp"
 #ifdef OPENMPI
@@ -76,6 +79,7 @@ Solver::Solver(Cost initUpperBound)
     , nbHybridContinue(0)
     , nbHybridNew(0)
     , nbRecomputationNodes(0)
+    , nbSavedRecomputationNodes(0)
     , initialLowerBound(MIN_COST)
     , globalLowerBound(MIN_COST)
     , globalUpperBound(MAX_COST)
@@ -97,7 +101,7 @@ Solver::~Solver()
 
 void Solver::initVarHeuristic()
 {
-    unassignedVars = new BTList<Value>(&Store::storeDomain);
+    unassignedVars = new BTList<Value>(&Store::trail);
     allVars = new DLink<Value>[wcsp->numberOfVariables()];
     for (unsigned int j = 0; j < wcsp->numberOfVariables(); j++) {
         unsigned int i = wcsp->getDACOrder(j);
@@ -260,9 +264,14 @@ void Solver::parse_solution(const char* certificate)
 
 void Solver::dump_wcsp(const char* fileName, bool original)
 {
-    ofstream pb(fileName);
-    if (pb)
-        wcsp->dump(pb, original);
+    string name(fileName);
+    if (name.size() >= 8 && name.compare(name.size() - 8, 8, ".wcspbin") == 0) {
+        wcsp->dump_wcspbin(fileName, original);
+        return;
+    }
+    CompressedOutput pb(fileName);
+    if (pb.good())
+        wcsp->dump(pb.stream(), original);
 }
 
 Cost Solver::getSolution(vector<Value>& solution)
@@ -568,6 +577,8 @@ int Solver::getMostUrgent()
 /// \brief Enforce WCSP upper-bound and backtrack if ub <= lb or in the case of probabilistic inference if the contribution is too small
 void Solver::enforceUb()
 {
+    if (Portfolio::getWorker() >= 0)
+        wcsp->updateUb(Portfolio::getUb()); // import best upper bound found by other portfolio or parallel HBFS workers
     wcsp->enforceUb();
     if (ToulBar2::isZ) {
         Cost newCost = wcsp->getLb() + wcsp->getNegativeLb();
@@ -1164,6 +1175,8 @@ void Solver::newSolution()
     wcsp->restoreSolution();
     if (!ToulBar2::isZ)
         wcsp->setSolution(wcsp->getLb());
+    if (Portfolio::getWorker() >= 0)
+        Portfolio::publish(wcsp, wcsp->getLb());
 
     if (ToulBar2::showSolutions) {
 
@@ -1365,6 +1378,11 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
         clb = MAX(clb, open_->getLb(delta));
         if (ToulBar2::verbose >= 1 && cluster)
             cout << "hybridSolve-2 C" << cluster->getId() << " " << clb << " " << cub << " " << delta << " " << open_->size() << " " << open_->top().getCost(delta) << " " << open_->getClosedNodesLb(delta) << " " << open_->getUb(delta) << endl;
+        bool incremental = (!cluster && ToulBar2::hbfsIncremental);
+        if (incremental) {
+            restoredBranch.clear();
+            restoredDepth.assign(1, Store::getDepth());
+        }
         while (clb < cub && !open_->finished() && (!cluster || (clb == initiallb && cub == initialub && nbBacktracks <= cluster->hbfsGlobalLimit))) {
             if (cluster) {
                 cluster->hbfsLimit = ((ToulBar2::hbfs > 0) ? (cluster->nbBacktracks + ToulBar2::hbfs) : LONGLONG_MAX);
@@ -1384,7 +1402,11 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
                         cout << "[C" << wcsp->getTreeDec()->getCurrentCluster()->getId() << "] ";
                     cout << "[ " << nd.getCost(delta) << ", " << cub << "] ( " << open_->size() << "+1 still open)" << endl;
                 }
-                restore(*cp_, nd);
+                if (incremental) {
+                    incrementalRestore(*cp_, nd);
+                    Store::store(); // keep the restored open node for the next incremental restoration
+                } else
+                    restore(*cp_, nd);
                 Cost bestlb = MAX(nd.getCost(delta), wcsp->getLb());
                 bestlb = MAX(bestlb, clb);
                 if (cluster) {
@@ -1406,9 +1428,12 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
                 cub = wcsp->getUb();
                 open_->updateUb(cub);
             }
-            Store::restore(storedepthBFS);
+            if (!incremental)
+                Store::restore(storedepthBFS);
             cp_->store();
             if (cp_->size() >= static_cast<std::size_t>(ToulBar2::hbfsCPLimit) || open_->size() >= static_cast<std::size_t>(ToulBar2::hbfsOpenNodeLimit)) {
+                if (ToulBar2::verbose >= 0)
+                    cout << "c hybrid best-first search limit reached with " << open_->size() << " open nodes and " << cp_->size() << " choice points, switching to depth-first search." << endl;
                 ToulBar2::hbfs = 0;
                 ToulBar2::hbfsGlobalLimit = 0;
                 if (cluster) {
@@ -1429,6 +1454,11 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
                     cout << "HBFS backtrack limit: " << ToulBar2::hbfs << endl;
             }
         }
+        if (incremental) {
+            Store::restore(restoredDepth[0]);
+            restoredBranch.clear();
+            restoredDepth.clear();
+        }
         assert(clb >= initiallb && cub <= initialub);
     } else {
         if (cluster) {
@@ -1544,6 +1574,8 @@ Cost Solver::preprocessing(Cost initialUpperBound)
             wcsp->propagate();
         }
     }
+    if ((ToulBar2::minsumDiffusion || ToulBar2::trws) && ToulBar2::vac)
+        ((WCSP*)wcsp)->vac->minsumDiffusion(); // dual ascent before variable elimination and other preprocessing techniques
     wcsp->preprocessing(); // preprocessing after initial propagation
     if (!ToulBar2::isZ) {
         Cost finiteUb = wcsp->finiteUb(); // find worst-case assignment finite cost plus one as new upper bound
@@ -1572,6 +1604,26 @@ Cost Solver::preprocessing(Cost initialUpperBound)
         if (ToulBar2::verbose >= 0)
             cout << "INCOP solving time: " << cpuTime() - incopStartTime << " seconds." << endl;
     }
+    if (ToulBar2::miniBucket > 0 && !ToulBar2::isZ && !ToulBar2::allSolutions && wcsp->numberOfUnassignedVariables() > 0) {
+        vector<int> variables;
+        vector<Value> values;
+        Cost bound = ((WCSP*)wcsp)->miniBucketElimination(variables, values);
+        if (variables.size() > 0) {
+            int depth = Store::getDepth();
+            try {
+                Store::store();
+                wcsp->assignLS(variables, values);
+                newSolution();
+            } catch (Contradiction) {
+                wcsp->whenContradiction();
+            }
+            Store::restore(depth);
+            wcsp->enforceUb();
+            wcsp->propagate();
+        }
+        if (bound >= wcsp->getUb())
+            THROWCONTRADICTION; // mini-bucket lower bound proves optimality of the current upper bound
+    }
     ToulBar2::lds = lds;
 
     if (ToulBar2::singletonConsistency) {
@@ -1801,7 +1853,10 @@ bool Solver::solve()
                                 cout << "HBFS open list restarts: " << (100. * (nbHybrid - nbHybridNew - nbHybridContinue) / nbHybrid) << " % and reuse: " << (100. * nbHybridContinue / nbHybrid) << " % of " << nbHybrid << endl;
                         } else {
                             initialDepth = Store::getDepth();
-                            hybridSolve();
+                            if (ToulBar2::hbfsWorkers > 1)
+                                parallelHybridSolve();
+                            else
+                                hybridSolve();
                         }
                     }
                 } catch (NbBacktracksOut) {
@@ -1816,6 +1871,11 @@ bool Solver::solve()
     } catch (NbSolutionsOut) {
     }
     //  Store::restore();         // see above for Store::store()
+    if (ToulBar2::portfolio > 1 && Portfolio::getWorker() >= 0) {
+        Portfolio::retrieve(wcsp);
+        if (!ToulBar2::limited)
+            Portfolio::finish();
+    }
     endSolve(wcsp->getUb() < initialUpperBound, wcsp->getUb(), !ToulBar2::limited);
     return (ToulBar2::isZ || ToulBar2::allSolutions || wcsp->getUb() < initialUpperBound);
 }
@@ -1863,6 +1923,10 @@ void Solver::endSolve(bool isSolution, Cost cost, bool isComplete)
 
     if (ToulBar2::verbose >= 0 && nbHybrid >= 1 && nbNodes > 0)
         cout << "Node redundancy during HBFS: " << 100. * nbRecomputationNodes / nbNodes << " %" << endl;
+    if (ToulBar2::verbose >= 0 && ToulBar2::costCheckpoint)
+        cout << "Copy-on-write checkpoints of cost tables: " << StoreCostTable::maxSize << " Bytes at most." << endl;
+    if (ToulBar2::verbose >= 0 && nbSavedRecomputationNodes > 0)
+        cout << "Node recomputations saved by incremental restoration: " << nbSavedRecomputationNodes << " (" << 100. * nbSavedRecomputationNodes / (nbSavedRecomputationNodes + nbRecomputationNodes) << " %)" << endl;
 
     if (isSolution) {
         if (ToulBar2::verbose >= 0 && !ToulBar2::uai && !ToulBar2::xmlflag && !ToulBar2::maxsateval) {
@@ -1946,9 +2010,6 @@ bool Solver::solve_symmax2sat(int n, int m, int* posx, int* posy, double* cost,
         wcsp->makeEnumeratedVariable(to_string(i), 0, 1);
     }
 
-    vector<Cost> unaryCosts0(n, 0);
-    vector<Cost> unaryCosts1(n, 0);
-
     // find total cost
     Double sumcost = 0.;
     for (int e = 0; e < m; e++) {
@@ -1957,36 +2018,8 @@ bool Solver::solve_symmax2sat(int n, int m, int* posx, int* posy, double* cost,
     Double multiplier = ((Double)MAX_COST) / sumcost;
     multiplier /= MEDIUM_COST;
 
-    // create weighted binary clauses
-    for (int e = 0; e < m; e++) {
-        if (posx[e] != posy[e]) {
-            vector<Cost> costs(4, 0);
-            if (cost[e] > 0) {
-                costs[1] = (Cost)(multiplier * 2. * cost[e]);
-                costs[2] = costs[1];
-            } else {
-                costs[0] = (Cost)(multiplier * -2. * cost[e]);
-                costs[3] = costs[0];
-            }
-            wcsp->postBinaryConstraint(posx[e] - 1, posy[e] - 1, costs);
-        } else {
-            if (cost[e] > 0) {
-                unaryCosts1[posx[e] - 1] += (Cost)(multiplier * cost[e]);
-            } else {
-                unaryCosts0[posx[e] - 1] += (Cost)(multiplier * -cost[e]);
-            }
-        }
-    }
-
-    // create weighted unary clauses
-    for (int i = 0; i < n; i++) {
-        if (unaryCosts0[i] > 0 || unaryCosts1[i] > 0) {
-            vector<Cost> costs(2, 0);
-            costs[0] = unaryCosts0[i];
-            costs[1] = unaryCosts1[i];
-            wcsp->postUnary(i, costs);
-        }
-    }
+    // create weighted binary and unary clauses (h = 1 <=> x = 0 and h = -1 <=> x = 1)
+    wcsp->postQuadraticBooleanFunction(n, m, posx, posy, cost, multiplier, false, false);
     wcsp->sortConstraints();
 
     if (ToulBar2::verbose >= 0)
@@ -2056,6 +2089,62 @@ void Solver::CPStore::addChoicePoint(ChoicePointOp op, int varIndex, Value value
     index = index + 1;
 }
 
+void Solver::CPStore::setPrefix(ptrdiff_t first, ptrdiff_t last, ptrdiff_t depth)
+{
+    assert(first <= last && last <= start);
+    assert(regions.empty() || regions.back().start < start);
+    Region region = { start, first, last, depth };
+    regions.push_back(region);
+}
+
+void Solver::CPStore::getBranch(ptrdiff_t first, ptrdiff_t last, vector<ChoicePoint>& branch) const
+{
+    // collect branch slices from the open node up to the root region
+    vector<pair<ptrdiff_t, ptrdiff_t>> slices;
+    slices.push_back(make_pair(first, last));
+    while (true) {
+        Region key = { slices.back().first, 0, 0, 0 };
+        vector<Region>::const_iterator it = lower_bound(regions.begin(), regions.end(), key);
+        if (it == regions.end() || it->start != slices.back().first)
+            break;
+        assert(it->first < it->start);
+        slices.push_back(make_pair(it->first, it->last));
+    }
+    branch.clear();
+    for (vector<pair<ptrdiff_t, ptrdiff_t>>::reverse_iterator slice = slices.rbegin(); slice != slices.rend(); ++slice) {
+        for (ptrdiff_t idx = slice->first; idx < slice->second; ++idx) {
+            assert((size_t)idx < size());
+            const ChoicePoint& c = operator[](idx);
+            if (c.reverse && idx < slice->second - 1) { // left branch of a choice point whose right branch is an open node
+                switch (c.op) {
+                case CP_ASSIGN:
+                    branch.push_back(ChoicePoint(CP_REMOVE, c.varIndex, c.value, false));
+                    break;
+                case CP_REMOVE:
+                    branch.push_back(ChoicePoint(CP_ASSIGN, c.varIndex, c.value, false));
+                    break;
+                case CP_INCREASE:
+                    branch.push_back(ChoicePoint(CP_DECREASE, c.varIndex, c.value - 1, false));
+                    break;
+                case CP_DECREASE:
+                    branch.push_back(ChoicePoint(CP_INCREASE, c.varIndex, c.value + 1, false));
+                    break;
+                default:
+                    branch.push_back(ChoicePoint((ChoicePointOp)c.op, c.varIndex, c.value, false));
+                }
+            } else
+                branch.push_back(ChoicePoint((ChoicePointOp)c.op, c.varIndex, c.value, false));
+        }
+    }
+}
+
+void Solver::CPStore::getPrefix(vector<ChoicePoint>& prefix) const
+{
+    prefix.clear();
+    if (!regions.empty() && regions.back().start == start)
+        getBranch(regions.back().first, regions.back().last, prefix);
+}
+
 void Solver::addChoicePoint(ChoicePointOp op, int varIndex, Value value, bool reverse)
 {
     TreeDecomposition* td = wcsp->getTreeDec();
@@ -2067,13 +2156,13 @@ void Solver::addChoicePoint(ChoicePointOp op, int varIndex, Value value, bool re
         cp_->addChoicePoint(op, varIndex, value, reverse);
         CPStore::size_type after = cp_->capacity();
         if (ToulBar2::verbose >= 0 && after > before && after > (1 << STORE_SIZE))
-            cout << "c " << after * sizeof(ChoicePointOp) + td->getCurrentCluster()->open->capacity() * sizeof(OpenNode) << " Bytes allocated for hybrid best-first search open nodes at cluster " << td->getCurrentCluster()->getId() << "." << endl;
+            cout << "c " << after * sizeof(ChoicePoint) + td->getCurrentCluster()->open->capacity() * sizeof(OpenNode) << " Bytes allocated for hybrid best-first search open nodes at cluster " << td->getCurrentCluster()->getId() << "." << endl;
     } else {
         CPStore::size_type before = cp->capacity();
         cp->addChoicePoint(op, varIndex, value, reverse);
         CPStore::size_type after = cp->capacity();
         if (ToulBar2::verbose >= 0 && after > before && after > (1 << STORE_SIZE))
-            cout << "c " << after * sizeof(ChoicePointOp) + open->capacity() * sizeof(OpenNode) << " Bytes allocated for hybrid best-first search open nodes." << endl;
+            cout << "c " << after * sizeof(ChoicePoint) + open->capacity() * sizeof(OpenNode) << " Bytes allocated for hybrid best-first search open nodes." << endl;
     }
 }
 
@@ -2086,8 +2175,13 @@ void Solver::addOpenNode(CPStore& cp, OpenList& open, Cost lb, Cost delta)
         cout << "add open node " << lb << " + " << delta << " (" << cp.start << ", " << idx << ")" << endl;
     }
     assert(cp.start <= idx);
-    open.push(OpenNode(MAX(MIN_COST, lb + delta), cp.start, idx));
+    open.push(OpenNode(MAX(MIN_COST, lb + delta), cp.start, idx, cp.getPrefixDepth() + idx - cp.start));
 
+    if (idx == cp.start) { // an empty open node refers to the prefix of the current region which must not be reused by the next region
+        if ((size_t)idx == cp.size())
+            cp.push_back(ChoicePoint(CP_ASSIGN, 0, 0, false)); // unused choice point
+        idx++;
+    }
     cp.stop = max(cp.stop, idx);
 }
 
@@ -2137,78 +2231,115 @@ void Solver::restore(CPStore& cp, OpenNode nd)
         }
     }
     assert(nd.last >= nd.first);
-    nbRecomputationNodes += nd.last - nd.first;
+    vector<ChoicePoint> branch;
+    cp.getBranch(nd.first, nd.last, branch);
+    nbRecomputationNodes += branch.size();
 
-    ptrdiff_t maxsize = nd.last - nd.first;
+    ptrdiff_t maxsize = branch.size();
     int assignLS[maxsize];
     Value valueLS[maxsize];
     unsigned int size = 0;
-    for (ptrdiff_t idx = nd.first; idx < nd.last; ++idx) {
-        assert((size_t)idx < cp.size());
-        assert(!wcsp->getTreeDec() || wcsp->getTreeDec()->getCurrentCluster()->isVar(cp[idx].varIndex));
-        if ((cp[idx].op == CP_ASSIGN && !(cp[idx].reverse && idx < nd.last - 1)) || (cp[idx].op == CP_REMOVE && cp[idx].reverse && idx < nd.last - 1)) {
-            assignLS[size] = cp[idx].varIndex;
-            valueLS[size] = cp[idx].value;
+    for (ptrdiff_t idx = 0; idx < maxsize; ++idx) {
+        assert(!wcsp->getTreeDec() || wcsp->getTreeDec()->getCurrentCluster()->isVar(branch[idx].varIndex));
+        if (branch[idx].op == CP_ASSIGN) {
+            assignLS[size] = branch[idx].varIndex;
+            valueLS[size] = branch[idx].value;
             size++;
         }
     }
     wcsp->enforceUb();
     wcsp->assignLS(assignLS, valueLS, size, false); // fast multiple assignments
-    for (ptrdiff_t idx = nd.first; idx < nd.last; ++idx) {
-        assert((size_t)idx < cp.size());
+    for (ptrdiff_t idx = 0; idx < maxsize; ++idx) {
         if (ToulBar2::verbose >= 1)
-            cout << "retrieve choice point " << CPOperation[cp[idx].op] << ((cp[idx].reverse) ? "*" : "") << " (" << wcsp->getName(cp[idx].varIndex) << ", " << cp[idx].value << ") at position " << idx << endl;
+            cout << "retrieve choice point " << CPOperation[branch[idx].op] << " (" << wcsp->getName(branch[idx].varIndex) << ", " << branch[idx].value << ") at depth " << idx << endl;
         if (ToulBar2::verbose >= 1)
-            cout << *((WCSP*)wcsp)->getVar(cp[idx].varIndex) << endl;
+            cout << *((WCSP*)wcsp)->getVar(branch[idx].varIndex) << endl;
         nbNodes++;
-        switch (cp[idx].op) { //TODO: some operations (remove,increase,decrease) are useless because of all assigns previously done
-        case CP_ASSIGN: {
-            if (cp[idx].reverse && idx < nd.last - 1) {
-                wcsp->remove(cp[idx].varIndex, cp[idx].value);
-                addChoicePoint(CP_REMOVE, cp[idx].varIndex, cp[idx].value, false);
-            } else
-                addChoicePoint(CP_ASSIGN, cp[idx].varIndex, cp[idx].value, false);
+        switch (branch[idx].op) { //TODO: some operations (remove,increase,decrease) are useless because of all assigns previously done
+        case CP_ASSIGN:
             break;
-        }
-        case CP_REMOVE: {
-            if (cp[idx].reverse && idx < nd.last - 1) {
-                addChoicePoint(CP_ASSIGN, cp[idx].varIndex, cp[idx].value, false);
-            } else {
-                wcsp->remove(cp[idx].varIndex, cp[idx].value);
-                addChoicePoint(CP_REMOVE, cp[idx].varIndex, cp[idx].value, false);
-            }
+        case CP_REMOVE:
+            wcsp->remove(branch[idx].varIndex, branch[idx].value);
             break;
-        }
-        case CP_INCREASE: {
-            if (cp[idx].reverse && idx < nd.last - 1) {
-                wcsp->decrease(cp[idx].varIndex, cp[idx].value - 1);
-                addChoicePoint(CP_DECREASE, cp[idx].varIndex, cp[idx].value - 1, false);
-            } else {
-                wcsp->increase(cp[idx].varIndex, cp[idx].value);
-                addChoicePoint(CP_INCREASE, cp[idx].varIndex, cp[idx].value, false);
-            }
+        case CP_INCREASE:
+            wcsp->increase(branch[idx].varIndex, branch[idx].value);
             break;
-        }
-        case CP_DECREASE: {
-            if (cp[idx].reverse && idx < nd.last - 1) {
-                wcsp->increase(cp[idx].varIndex, cp[idx].value + 1);
-                addChoicePoint(CP_INCREASE, cp[idx].varIndex, cp[idx].value + 1, false);
-            } else {
-                wcsp->decrease(cp[idx].varIndex, cp[idx].value);
-                addChoicePoint(CP_DECREASE, cp[idx].varIndex, cp[idx].value, false);
-            }
+        case CP_DECREASE:
+            wcsp->decrease(branch[idx].varIndex, branch[idx].value);
             break;
-        }
         default: {
             cerr << "unknown choice point for hybrid best first search!!!" << endl;
             exit(EXIT_FAILURE);
         }
         }
     }
+    // new choice points will share the restored branch as a prefix instead of copying it
+    assert(nd.depth == maxsize);
+    assert(nd.last <= cp.start);
+    if (nd.depth > 0)
+        cp.setPrefix(nd.first, nd.last, nd.depth);
     wcsp->propagate();
     //if (wcsp->getLb() != nd.getCost(((wcsp->getTreeDec())?wcsp->getTreeDec()->getCurrentCluster()->getCurrentDelta():MIN_COST))) cout << "***** node cost: " << nd.getCost(((wcsp->getTreeDec())?wcsp->getTreeDec()->getCurrentCluster()->getCurrentDelta():MIN_COST)) << " but lb: " << wcsp->getLb() << endl;
 }
 
+void Solver::incrementalRestore(CPStore& cp, OpenNode nd)
+{
+    if (ToulBar2::verbose >= 1)
+        cout << "restore open node " << nd.getCost(MIN_COST) << " (" << nd.first << ", " << nd.last << ") incrementally" << endl;
+    assert(!wcsp->getTreeDec());
+    assert(nd.last >= nd.first);
+    assert(restoredDepth.size() == restoredBranch.size() + 1);
+    vector<ChoicePoint> branch;
+    cp.getBranch(nd.first, nd.last, branch);
+
+    // backtrack to the deepest common ancestor with the previously restored open node
+    size_t common = 0;
+    while (common < restoredBranch.size() && common < branch.size() && restoredBranch[common].op == branch[common].op && restoredBranch[common].varIndex == branch[common].varIndex && restoredBranch[common].value == branch[common].value)
+        common++;
+    assert(Store::getDepth() >= restoredDepth[common]);
+    Store::restore(restoredDepth[common]);
+    cp.index = cp.start; // backtrackable position of the next choice point must not come back to a previous region
+    restoredBranch.erase(restoredBranch.begin() + common, restoredBranch.end());
+    restoredDepth.resize(common + 1);
+    nbSavedRecomputationNodes += common;
+    nbRecomputationNodes += branch.size() - common;
+
+    assert(nd.depth == (ptrdiff_t)branch.size());
+    assert(nd.last <= cp.start);
+    if (nd.depth > 0)
+        cp.setPrefix(nd.first, nd.last, nd.depth);
+
+    // replay the differing suffix, each choice point in its own Store level to be kept for the next open nodes
+    wcsp->enforceUb();
+    for (size_t idx = common; idx < branch.size(); ++idx) {
+        if (ToulBar2::verbose >= 1)
+            cout << "retrieve choice point " << CPOperation[branch[idx].op] << " (" << wcsp->getName(branch[idx].varIndex) << ", " << branch[idx].value << ") at depth " << idx << endl;
+        nbNodes++;
+        Store::store();
+        switch (branch[idx].op) {
+        case CP_ASSIGN:
+            wcsp->assign(branch[idx].varIndex, branch[idx].value);
+            break;
+        case CP_REMOVE:
+            wcsp->remove(branch[idx].varIndex, branch[idx].value);
+            break;
+        case CP_INCREASE:
+            wcsp->increase(branch[idx].varIndex, branch[idx].value);
+            break;
+        case CP_DECREASE:
+            wcsp->decrease(branch[idx].varIndex, branch[idx].value);
+            break;
+        default: {
+            cerr << "unknown choice point for hybrid best first search!!!" << endl;
+            exit(EXIT_FAILURE);
+        }
+        }
+        wcsp->propagate();
+        restoredBranch.push_back(branch[idx]);
+        restoredDepth.push_back(Store::getDepth());
+    }
+}
+
 /* Local Variables: */
 /* c-basic-offset: 4 */
 /* tab-width: 4 */
@@ -29,14 +29,16 @@ public:
     public:
         ptrdiff_t first; // first position in the list of choice points corresponding to a branch in order to reconstruct the open node
         ptrdiff_t last; // last position (excluded) in the list of choice points corresponding to a branch in order to reconstruct the open node
+        ptrdiff_t depth; // number of choice points of the whole branch (including the prefix shared with other open nodes, see CPStore::setPrefix)
 
-        OpenNode(Cost cost_, ptrdiff_t first_, ptrdiff_t last_)
+        OpenNode(Cost cost_, ptrdiff_t first_, ptrdiff_t last_, ptrdiff_t depth_)
             : cost(cost_)
             , first(first_)
             , last(last_)
+            , depth(depth_)
         {
         }
-        bool operator<(const OpenNode& right) const { return (cost > right.cost) || (cost == right.cost && ((last - first) < (right.last - right.first) || ((last - first) == (right.last - right.first) && last >= right.last))); } // reverse order to get the open node with first, the smallest lower bound, and next, the deepest depth, and next, the oldest time-stamp
+        bool operator<(const OpenNode& right) const { return (cost > right.cost) || (cost == right.cost && (depth < right.depth || (depth == right.depth && last >= right.last))); } // reverse order to get the open node with first, the smallest lower bound, and next, the deepest depth, and next, the oldest time-stamp
 
         Cost getCost(Cost delta = MIN_COST) const { return MAX(MIN_COST, cost - delta); }
     };
@@ -95,21 +97,32 @@ public:
     static const string CPOperation[CP_MAX]; // for pretty print
 
     struct ChoicePoint {
-        ChoicePointOp op; // choice point operation
-        int varIndex; // variable wcsp's index
+        unsigned int op : 3; // choice point operation (ChoicePointOp)
+        unsigned int reverse : 1; // true if the choice point corresponds to the last right branch of an open node
+        unsigned int varIndex : 28; // variable wcsp's index
         Value value; // variable's value
-        bool reverse; // true if the choice point corresponds to the last right branch of an open node
 
         ChoicePoint(ChoicePointOp op_, int var_, Value val_, bool rev_)
             : op(op_)
+            , reverse(rev_)
             , varIndex(var_)
             , value(val_)
-            , reverse(rev_)
         {
+            assert(var_ >= 0 && var_ < (1 << 28));
         }
     };
 
     class CPStore FINAL : public vector<ChoicePoint> {
+        struct Region {
+            ptrdiff_t start; // first position of the region
+            ptrdiff_t first; // open node restored before adding the choice points of this region
+            ptrdiff_t last;
+            ptrdiff_t depth; // number of choice points of the whole branch of this open node
+
+            bool operator<(const Region& right) const { return start < right.start; }
+        };
+        vector<Region> regions; // sorted by increasing start position (regions without a restored open node are not recorded)
+
     public:
         ptrdiff_t start; // beginning of the current branch
         ptrdiff_t stop; // deepest saved branch end (should be free at this position)
@@ -125,14 +138,34 @@ public:
         void addChoicePoint(ChoicePointOp op, int varIndex, Value value, bool reverse);
         void store()
         {
+            if (!regions.empty() && regions.back().start == stop)
+                regions.pop_back(); // no open node refers to this empty region
             start = stop;
             index = start;
         }
+        void clear()
+        {
+            vector<ChoicePoint>::clear();
+            regions.clear();
+            start = 0;
+            stop = 0;
+            index = 0;
+        }
+
+        /// \brief records that the open node [first,last) has been restored before adding choice points in the current region (shared prefix instead of a copy)
+        void setPrefix(ptrdiff_t first, ptrdiff_t last, ptrdiff_t depth);
+        /// \brief returns the number of choice points of the prefix shared by all open nodes of the current region
+        ptrdiff_t getPrefixDepth() const { return (!regions.empty() && regions.back().start == start) ? regions.back().depth : 0; }
+        /// \brief returns the choice points of the whole branch of open node [first,last), including the prefixes of its enclosing regions, without reverse flags
+        void getBranch(ptrdiff_t first, ptrdiff_t last, vector<ChoicePoint>& branch) const;
+        /// \brief returns the choice points of the prefix shared by all open nodes of the current region, without reverse flags
+        void getPrefix(vector<ChoicePoint>& prefix) const;
     };
 
     void addChoicePoint(ChoicePointOp op, int varIndex, Value value, bool reverse);
     void addOpenNode(CPStore& cp, OpenList& open, Cost lb, Cost delta = MIN_COST); ///< \param delta cost moved out from the cluster by soft arc consistency
     void restore(CPStore& cp, OpenNode node);
+    void incrementalRestore(CPStore& cp, OpenNode node); ///< \warning the Store depth must not be lower than the one after the choice points kept in common with the previously restored open node
 
 protected:
     friend class NeighborhoodStructure;
@@ -164,6 +197,9 @@ protected:
     Long nbHybridContinue;
     Long nbHybridNew;
     Long nbRecomputationNodes;
+    Long nbSavedRecomputationNodes; // choice points kept in common with the previously restored open node (see ToulBar2::hbfsIncremental)
+    vector<ChoicePoint> restoredBranch; // choice points applied by the last incremental restoration
+    vector<int> restoredDepth; // Store depth before applying each choice point of restoredBranch (and after the last one)
 
     //only for pretty print of optimality gap information
     Cost initialLowerBound;
@@ -222,6 +258,7 @@ protected:
     pair<Cost, Cost> recursiveSolve(Cluster* cluster, Cost lbgood, Cost cub);
     pair<Cost, Cost> hybridSolve(Cluster* root, Cost clb, Cost cub);
     pair<Cost, Cost> hybridSolve() { return hybridSolve(NULL, wcsp->getLb(), wcsp->getUb()); }
+    pair<Cost, Cost> parallelHybridSolve(); ///< \brief hybrid best-first search with ToulBar2::hbfsWorkers processes sharing their open nodes (without tree decomposition)
     pair<Cost, Cost> russianDollSearch(Cluster* c, Cost cub);
 
     BigInteger binaryChoicePointSBTD(Cluster* cluster, int varIndex, Value value);
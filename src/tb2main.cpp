@@ -8,6 +8,8 @@
 #include "applis/tb2bep.hpp"
 #include "vns/tb2vnsutils.hpp"
 #include "vns/tb2dgvns.hpp"
+#include "search/tb2portfolio.hpp"
+#include "utils/tb2compression.hpp"
 #ifdef OPENMPI
 #include "vns/tb2cpdgvns.hpp"
 #include "vns/tb2rpdgvns.hpp"
@@ -62,6 +64,7 @@ void initCosts()
         cerr << "VAC not implemented on Paretopair." << endl;
         ToulBar2::vac = 0;
         ToulBar2::minsumDiffusion = 0;
+        ToulBar2::trws = 0;
     }
     if (ToulBar2::elimDegree >= 0 || ToulBar2::elimDegree_preprocessing >= 0 || ToulBar2::elimDegree_preprocessing < -1) {
         cerr << "Variable elimination not implemented on Paretopair." << endl;
@@ -125,6 +128,7 @@ enum {
     OPT_wcnf_ext,
     OPT_cnf_ext,
     OPT_qpbo_ext,
+    OPT_wcspbin_ext,
     OPT_treedec_ext,
     OPT_clusterdec_ext,
 
@@ -165,6 +169,9 @@ enum {
     NO_OPT_elimDegree,
     OPT_elimDegree_preprocessing,
     NO_OPT_elimDegree_preprocessing,
+    OPT_miniBucket,
+    OPT_miniBucketMaxMB,
+    OPT_miniBucketSpillMB,
     OPT_showSolutions,
     OPT_costfuncSeparate,
     NO_OPT_costfuncSeparate,
@@ -172,6 +179,7 @@ enum {
 
     // VAC OPTION
     OPT_minsumDiffusion,
+    OPT_trws,
     OPT_vac,
     NO_OPT_vac,
     OPT_costThreshold,
@@ -181,6 +189,8 @@ enum {
     NO_OPT_singletonConsistency,
     OPT_vacValueHeuristic,
     NO_OPT_vacValueHeuristic,
+    OPT_vacIncremental,
+    NO_OPT_vacIncremental,
     OPT_preprocessTernary,
     NO_OPT_preprocessTernary,
     OPT_preprocessFunctional,
@@ -200,6 +210,12 @@ enum {
     OPT_hbfs,
     NO_OPT_hbfs,
     OPT_open,
+    OPT_hbfsinc,
+    NO_OPT_hbfsinc,
+    OPT_cow,
+    OPT_portfolio,
+    OPT_phbfs,
+    OPT_threads,
     OPT_localsearch,
     NO_OPT_localsearch,
     OPT_EDAC,
@@ -212,13 +228,13 @@ enum {
     OPT_verifyopt,
 #endif
     // MENDELESOFT OPTION
-    OPT_generation = 99,
-    MENDEL_OPT_genotypingErrorRate = 100,
-    MENDEL_OPT_resolution = 101,
-    OPT_pedigree_by_MPE = 102,
-    MENDEL_OPT_EQUAL_FREQ = 103,
-    MENDEL_OPT_ESTIMAT_FREQ = 104,
-    MENDEL_OPT_ALLOCATE_FREQ = 105,
+    OPT_generation = 500, // above the identifiers of all the previous options
+    MENDEL_OPT_genotypingErrorRate = 501,
+    MENDEL_OPT_resolution = 502,
+    OPT_pedigree_by_MPE = 503,
+    MENDEL_OPT_EQUAL_FREQ = 504,
+    MENDEL_OPT_ESTIMAT_FREQ = 505,
+    MENDEL_OPT_ALLOCATE_FREQ = 506,
 
     // random generator
     OPT_seed,
@@ -286,6 +302,7 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { OPT_wcnf_ext, (char*)"--wcnf_ext", SO_REQ_SEP },
     { OPT_cnf_ext, (char*)"--cnf_ext", SO_REQ_SEP },
     { OPT_qpbo_ext, (char*)"--qpbo_ext", SO_REQ_SEP },
+    { OPT_wcspbin_ext, (char*)"--wcspbin_ext", SO_REQ_SEP },
     { OPT_treedec_ext, (char*)"--treedec_ext", SO_REQ_SEP },
     { OPT_clusterdec_ext, (char*)"--clusterdec_ext", SO_REQ_SEP },
 
@@ -337,6 +354,9 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { NO_OPT_elimDegree, (char*)"-e:", SO_NONE },
     { OPT_elimDegree_preprocessing, (char*)"-p", SO_OPT },
     { NO_OPT_elimDegree_preprocessing, (char*)"-p:", SO_NONE },
+    { OPT_miniBucket, (char*)"-mbe", SO_OPT },
+    { OPT_miniBucketMaxMB, (char*)"-mbemem", SO_REQ_SEP },
+    { OPT_miniBucketSpillMB, (char*)"-mbespill", SO_REQ_SEP },
     { OPT_costfuncSeparate, (char*)"-dec", SO_NONE },
     { NO_OPT_costfuncSeparate, (char*)"-dec:", SO_NONE },
     { OPT_nopre, (char*)"-nopre", SO_NONE },
@@ -345,12 +365,15 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { NO_OPT_vac, (char*)"-A:", SO_NONE },
     { OPT_vacValueHeuristic, (char*)"-V", SO_NONE },
     { NO_OPT_vacValueHeuristic, (char*)"-V:", SO_NONE },
+    { OPT_vacIncremental, (char*)"-vacinc", SO_OPT },
+    { NO_OPT_vacIncremental, (char*)"-vacinc:", SO_NONE },
     { OPT_costThreshold, (char*)"-T", SO_REQ_SEP },
     { OPT_costThresholdPre, (char*)"-P", SO_REQ_SEP },
     { OPT_costMultiplier, (char*)"-C", SO_REQ_SEP },
 
     //preprocessing
     { OPT_minsumDiffusion, (char*)"-M", SO_REQ_SEP },
+    { OPT_trws, (char*)"-trws", SO_OPT },
     { OPT_singletonConsistency, (char*)"-S", SO_NONE },
     { OPT_preprocessTernary, (char*)"-t", SO_OPT },
     { NO_OPT_preprocessTernary, (char*)"-t:", SO_NONE },
@@ -373,6 +396,12 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { NO_OPT_hbfs, (char*)"-hbfs:", SO_NONE },
     { NO_OPT_hbfs, (char*)"-bfs:", SO_NONE },
     { OPT_open, (char*)"-open", SO_REQ_SEP },
+    { OPT_hbfsinc, (char*)"-hbfsinc", SO_NONE },
+    { NO_OPT_hbfsinc, (char*)"-hbfsinc:", SO_NONE },
+    { OPT_cow, (char*)"-cow", SO_REQ_SEP },
+    { OPT_portfolio, (char*)"-portfolio", SO_REQ_SEP },
+    { OPT_phbfs, (char*)"-phbfs", SO_REQ_SEP },
+    { OPT_threads, (char*)"-threads", SO_REQ_SEP },
     { OPT_localsearch, (char*)"-i", SO_OPT }, // incop option default or string for narycsp argument
     { OPT_EDAC, (char*)"-k", SO_REQ_SEP },
     { OPT_ub, (char*)"-ub", SO_REQ_SEP }, // init upper bound in cli
@@ -579,6 +608,7 @@ void help_msg(char* toulbar2filename)
     cout << "   *.wcnf : Weighted Partial Max-SAT format (see Max-SAT Evaluation)" << endl;
     cout << "   *.cnf : (Max-)SAT format" << endl;
     cout << "   *.qpbo : quadratic pseudo-Boolean optimization (unconstrained quadratic programming) format" << endl;
+    cout << "   *.wcspbin : binary snapshot of a problem saved by option -z (see below)" << endl;
 #ifdef XMLFLAG
     cout << "   *.xml : CSP and weighted CSP in XML format XCSP 2.1";
 #ifdef MAXCSP
@@ -599,6 +629,7 @@ void help_msg(char* toulbar2filename)
     cout << "      each line contains a list of variable indexes" << endl;
     cout << "   *.sol  : initial solution for the problem (given as initial upperbound plus one and as default value heuristic, or only as initial upperbound if option -x: is added)" << endl
          << endl;
+    cout << "Problem files in wcsp, cfn, uai, LG, wcnf, cnf and qpbo formats (and the standard input) can be compressed by gzip, xz or zstd (with an additional .gz, .xz or .zst extension)." << endl;
     cout << "Warning! a New file extension can be enforced using --foo_ext=\".myext\" ex: --wcsp_ext='.test' --sol_ext='.sol2'  " << endl;
     cout << endl;
 #endif
@@ -657,6 +688,9 @@ void help_msg(char* toulbar2filename)
     cout << endl;
     cout << "   -e=[integer] : boosting search with variable elimination of small degree (less than or equal to 3) (default value is " << ToulBar2::elimDegree << ")" << endl;
     cout << "   -p=[integer] : preprocessing only: general variable elimination of degree less than or equal to the given value (default value is " << ToulBar2::elimDegree_preprocessing << ")" << endl;
+    cout << "   -mbe=[integer] : preprocessing only: mini-bucket elimination with a given i-bound (maximum number of variables per mini-bucket) giving a lower bound and a greedy initial solution, both optimal if no bucket is split (default i-bound is 10 if no integer given)" << endl;
+    cout << "   -mbemem=[integer] : memory reserved for mini-bucket cost tables in MB (default value is " << ToulBar2::miniBucketMaxMB << ")" << endl;
+    cout << "   -mbespill=[integer] : size in MB of a memory-mapped scratch file in TMPDIR (or /tmp) used for mini-bucket cost tables not fitting in memory (default value is " << ToulBar2::miniBucketSpillMB << ")" << endl;
     cout << "   -t=[integer] : preprocessing only: simulates restricted path consistency by adding ternary cost functions on triangles of binary cost functions within a given maximum space limit (in MB)";
     if (ToulBar2::preprocessTernaryRPC)
         cout << " (" << ToulBar2::preprocessTernaryRPC << " MB)";
@@ -678,6 +712,7 @@ void help_msg(char* toulbar2filename)
     if (ToulBar2::QueueComplexity)
         cout << " (default option)";
     cout << endl;
+    cout << "   -cow=[integer] : checkpoints cost tables by copy-on-write pages instead of trailing each modified cost, for binary (cow=1), ternary (cow=2), or both (cow=3) cost functions (default value is " << ToulBar2::costCheckpoint << ")" << endl;
     cout << "   -k=[integer] : soft local consistency level (NC with Strong NIC for global cost functions=0, (G)AC=1, D(G)AC=2, FD(G)AC=3, (weak) ED(G)AC=4) (default value is " << ToulBar2::LcLevel << ")" << endl;
     cout << "   -dee=[integer] : restricted dead-end elimination (value pruning by dominance rule from EAC value (dee>=1 and dee<=3)) and soft neighborhood substitutability (in preprocessing (dee=2 or dee=4) or during search (dee=3)) (default value is " << ToulBar2::DEE << ")" << endl;
     cout << "   -l=[integer] : limited discrepancy search, use a negative value to stop the search after the given absolute number of discrepancies has been explored (discrepancy bound = " << maxdiscrepancy << " by default)";
@@ -709,6 +744,8 @@ void help_msg(char* toulbar2filename)
     cout << endl;
     cout << "   -z=[filename] : saves problem in wcsp format in filename (or \"problem.wcsp\"  if no parameter is given)" << endl;
     cout << "                   writes also the  graphviz dot file  and the degree distribution of the input problem" << endl;
+    cout << "                   (or saves a binary snapshot, loaded without parsing, if filename has \".wcspbin\" extension)" << endl;
+    cout << "                   (the wcsp file is compressed if filename has an additional \".gz\", \".xz\" or \".zst\" extension)" << endl;
     cout << "   -z=[integer] : 1: saves original instance (by default), 2: saves after preprocessing" << endl;
     cout << "   -Z=[integer] : debug mode (save problem at each node if verbosity option -v=num >= 1 and -Z=num >=3)" << endl;
 #ifndef NDEBUG
@@ -716,8 +753,13 @@ void help_msg(char* toulbar2filename)
 #endif
     cout << "   -x=[(,i=a)*] : assigns variable of index i to value a (multiple assignments are separated by a comma and no space) (without any argument, a complete assignment -- used as initial upper bound and as value heuristic -- read from default file \"sol\" taken as a certificate or given as input filename with \".sol\" extension)" << endl
          << endl;
-    cout << "   -M=[integer] : preprocessing only: Min Sum Diffusion algorithm (default number of iterations is " << ToulBar2::minsumDiffusion << ")" << endl;
+    cout << "   -M=[integer] : preprocessing only: Min Sum Diffusion algorithm, in parallel on variables sharing no cost function (see -threads) (default number of iterations is " << ToulBar2::minsumDiffusion << ")" << endl;
+    cout << "   -trws=[integer] : preprocessing only: TRW-S like sequential dual ascent by forward and backward passes in DAC order, after Min Sum Diffusion if both are used (default number of iterations is 100 if no integer given)" << endl;
     cout << "   -A=[integer] : enforces VAC at each search node with a search depth less than a given value (default value is " << ToulBar2::vac << ")" << endl;
+    cout << "   -vacinc=[integer] : incremental VAC in search, starting from the threshold of the parent node and only from the variables modified since its VAC, with an initial limit on the number of VAC iterations per node, adapted during search (default value is 10 if no integer given)";
+    if (ToulBar2::vacIncremental)
+        cout << " (default option)";
+    cout << endl;
     cout << "   -T=[decimal] : threshold cost value for VAC (default value is " << ToulBar2::costThreshold << ")" << endl;
     cout << "   -P=[decimal] : threshold cost value for VAC during the preprocessing phase (default value is " << ToulBar2::costThresholdPre << ")" << endl;
     cout << "   -C=[float] : multiplies all costs internally by this number when loading the problem (default value is " << ToulBar2::costMultiplier << ")" << endl;
@@ -761,6 +803,15 @@ void help_msg(char* toulbar2filename)
     cout << endl;
     cout << "   -hbfs=[integer] : hybrid best-first search, restarting from the root after a given number of backtracks (default value is " << hbfsgloballimit << ")" << endl;
     cout << "   -open=[integer] : hybrid best-first search limit on the number of open nodes (default value is " << ToulBar2::hbfsOpenNodeLimit << ")" << endl;
+    cout << "   -hbfsinc : hybrid best-first search restores each open node from its deepest common ancestor with the previous one instead of from the root (no tree decomposition)";
+    if (ToulBar2::hbfsIncremental)
+        cout << " (default option)";
+    cout << endl;
+#ifdef LINUX
+    cout << "   -portfolio=[integer] : runs a portfolio of a given number of differently-configured solver processes (other seeds, DFS/HBFS, LDS, restarts, VAC during search or not) sharing their best upper bound, stopping when the first one completes its search (DFS/HBFS only)" << endl;
+    cout << "   -phbfs=[integer] : parallel hybrid best-first search with a given number of worker processes sharing the list of open nodes (no tree decomposition)" << endl;
+#endif
+    cout << "   -threads=[integer] : number of threads used to convert the factor tables of uai files into cost tables and to seek supports in VAC Pass1 for variables with many large neighbor domains, and to run Min Sum Diffusion (default value is 0, meaning as many threads as cores)" << endl;
     cout << "---------------------------" << endl;
     cout << "Alternatively one can call the random problem generator with the following options: " << endl;
     cout << endl;
@@ -846,6 +897,7 @@ int _tmain(int argc, TCHAR* argv[])
     file_extension_map["wcnf_ext"] = ".wcnf";
     file_extension_map["cnf_ext"] = ".cnf";
     file_extension_map["qpbo_ext"] = ".qpbo";
+    file_extension_map["wcspbin_ext"] = ".wcspbin";
     file_extension_map["treedec_ext"] = ".cov";
     file_extension_map["clusterdec_ext"] = ".dec";
 
@@ -1308,6 +1360,26 @@ int _tmain(int argc, TCHAR* argv[])
                     cout << "elimDegree_preprocessing OFF: " << ToulBar2::elimDegree_preprocessing << endl;
             }
 
+            // mbe[integer]: preprocessing only: mini-bucket elimination with a given i-bound
+            if (args.OptionId() == OPT_miniBucket) {
+                ToulBar2::miniBucket = 10;
+                if (args.OptionArg() != NULL) {
+                    int ibound = atoi(args.OptionArg());
+                    if (ibound >= 0)
+                        ToulBar2::miniBucket = ibound;
+                }
+            }
+            if (args.OptionId() == OPT_miniBucketMaxMB) {
+                int size = atoi(args.OptionArg());
+                if (size > 0)
+                    ToulBar2::miniBucketMaxMB = size;
+            }
+            if (args.OptionId() == OPT_miniBucketSpillMB) {
+                int size = atoi(args.OptionArg());
+                if (size >= 0)
+                    ToulBar2::miniBucketSpillMB = size;
+            }
+
             // VAC PARAMETER
             if (args.OptionId() == OPT_minsumDiffusion)
 
@@ -1319,6 +1391,16 @@ int _tmain(int argc, TCHAR* argv[])
                 if (nit > 0)
                     ToulBar2::minsumDiffusion = nit;
             }
+            if (args.OptionId() == OPT_trws) {
+                if (!ToulBar2::vac)
+                    ToulBar2::vac = 1;
+                ToulBar2::trws = 100;
+                if (args.OptionArg() != NULL) {
+                    int nit = atoi(args.OptionArg());
+                    if (nit > 0)
+                        ToulBar2::trws = nit;
+                }
+            }
 
             if (args.OptionId() == OPT_vac) {
                 ToulBar2::vac = 1;
@@ -1363,6 +1445,17 @@ int _tmain(int argc, TCHAR* argv[])
                 ToulBar2::vacValueHeuristic = true;
             else if (args.OptionId() == NO_OPT_vacValueHeuristic)
                 ToulBar2::vacValueHeuristic = false;
+            if (args.OptionId() == OPT_vacIncremental) {
+                ToulBar2::vacIncremental = 10;
+                if (args.OptionArg() != NULL) {
+                    int nbit = atoi(args.OptionArg());
+                    if (nbit >= 1)
+                        ToulBar2::vacIncremental = nbit;
+                }
+                if (ToulBar2::debug)
+                    cout << "incremental VAC in search with at most " << ToulBar2::vacIncremental << " initial iterations per node" << endl;
+            } else if (args.OptionId() == NO_OPT_vacIncremental)
+                ToulBar2::vacIncremental = 0;
             if (args.OptionId() == OPT_preprocessTernary) {
                 if (args.OptionArg() != NULL) {
                     int size = atol(args.OptionArg());
@@ -1519,6 +1612,49 @@ int _tmain(int argc, TCHAR* argv[])
                 if (ToulBar2::debug)
                     cout << "hybrid BFS ON with open node limit = " << ToulBar2::hbfsOpenNodeLimit << endl;
             }
+            if (args.OptionId() == OPT_hbfsinc) {
+                if (ToulBar2::debug)
+                    cout << "incremental restoration of open nodes ON" << endl;
+                ToulBar2::hbfsIncremental = true;
+            } else if (args.OptionId() == NO_OPT_hbfsinc) {
+                if (ToulBar2::debug)
+                    cout << "incremental restoration of open nodes OFF" << endl;
+                ToulBar2::hbfsIncremental = false;
+            }
+
+            if (args.OptionId() == OPT_cow) {
+                int cow = atoi(args.OptionArg());
+                if (cow >= 0)
+                    ToulBar2::costCheckpoint = cow;
+                if (ToulBar2::debug)
+                    cout << "copy-on-write checkpointing of cost tables = " << ToulBar2::costCheckpoint << endl;
+            }
+
+            if (args.OptionId() == OPT_portfolio) {
+                int nbworkers = atoi(args.OptionArg());
+                if (nbworkers > 1)
+                    ToulBar2::portfolio = nbworkers;
+                if (ToulBar2::debug)
+                    cout << "portfolio search with " << ToulBar2::portfolio << " solvers" << endl;
+            }
+            if (args.OptionId() == OPT_phbfs) {
+                int nbworkers = atoi(args.OptionArg());
+                if (nbworkers > 1) {
+                    ToulBar2::hbfsWorkers = nbworkers;
+                    if (ToulBar2::hbfsGlobalLimit == 0)
+                        ToulBar2::hbfsGlobalLimit = hbfsgloballimit;
+                    ToulBar2::hbfs = 1;
+                }
+                if (ToulBar2::debug)
+                    cout << "parallel hybrid BFS with " << ToulBar2::hbfsWorkers << " workers" << endl;
+            }
+            if (args.OptionId() == OPT_threads) {
+                int nbthreads = atoi(args.OptionArg());
+                if (nbthreads >= 0)
+                    ToulBar2::nbThreads = nbthreads;
+                if (ToulBar2::debug)
+                    cout << "reading cost tables and enforcing VAC with " << ToulBar2::nbThreads << " threads" << endl;
+            }
 
             // local search INCOP
             if (args.OptionId() == OPT_localsearch) {
@@ -1761,15 +1897,16 @@ int _tmain(int argc, TCHAR* argv[])
             string problem = "";
             if (n < glob.FileCount())
                 problem = to_string(glob.File(n));
+            string format = uncompressedName(problem); // problem files can be compressed by gzip, xz or zstd
 
-            if (check_file_ext(problem, file_extension_map["wcsp_ext"]) || ToulBar2::stdin_format.compare("wcsp") == 0) {
+            if (check_file_ext(format, file_extension_map["wcsp_ext"]) || ToulBar2::stdin_format.compare("wcsp") == 0) {
                 if (ToulBar2::verbose >= 0)
                     cout << "loading wcsp file: " << problem << endl;
                 strext = ".wcsp";
                 strfile = problem;
             }
             // CFN file
-            if (check_file_ext(problem, file_extension_map["cfn_ext"]) || ToulBar2::stdin_format.compare("cfn") == 0) {
+            if (check_file_ext(format, file_extension_map["cfn_ext"]) || ToulBar2::stdin_format.compare("cfn") == 0) {
                 if (ToulBar2::verbose >= 0)
                     cout << "loading cfn file: " << problem << endl;
                 strext = ".cfn";
@@ -1785,7 +1922,7 @@ int _tmain(int argc, TCHAR* argv[])
                 ToulBar2::cfngz = true;
             }
             // uai  file
-            if (check_file_ext(problem, file_extension_map["uai_ext"]) || ToulBar2::stdin_format.compare("uai") == 0) {
+            if (check_file_ext(format, file_extension_map["uai_ext"]) || ToulBar2::stdin_format.compare("uai") == 0) {
                 strfile = problem;
                 strext = ".uai";
                 if (ToulBar2::verbose >= 0)
@@ -1794,7 +1931,7 @@ int _tmain(int argc, TCHAR* argv[])
                 ToulBar2::bayesian = true;
             }
             // uai log file
-            if (check_file_ext(problem, file_extension_map["uai_log_ext"]) || ToulBar2::stdin_format.compare("LG") == 0) {
+            if (check_file_ext(format, file_extension_map["uai_log_ext"]) || ToulBar2::stdin_format.compare("LG") == 0) {
                 strfile = problem;
                 strext = ".LG";
                 if (ToulBar2::verbose >= 0)
@@ -1823,13 +1960,13 @@ int _tmain(int argc, TCHAR* argv[])
 
             // wcnf or cnf file
 
-            if (check_file_ext(problem, file_extension_map["wcnf_ext"]) || ToulBar2::stdin_format.compare("wcnf") == 0 || ToulBar2::stdin_format.compare("cnf") == 0) {
+            if (check_file_ext(format, file_extension_map["wcnf_ext"]) || ToulBar2::stdin_format.compare("wcnf") == 0 || ToulBar2::stdin_format.compare("cnf") == 0) {
                 if (ToulBar2::verbose >= 0)
                     cout << "loading wcnf file:" << problem << endl;
                 ToulBar2::wcnf = true;
                 strext = ".wcnf";
                 strfile = problem;
-            } else if (check_file_ext(problem, file_extension_map["cnf_ext"])) {
+            } else if (check_file_ext(format, file_extension_map["cnf_ext"])) {
                 if (ToulBar2::verbose >= 0)
                     cout << "loading cnf file:" << problem << endl;
                 ToulBar2::wcnf = true;
@@ -1839,7 +1976,7 @@ int _tmain(int argc, TCHAR* argv[])
 
             // unconstrained quadratic programming file
 
-            if (check_file_ext(problem, file_extension_map["qpbo_ext"]) || ToulBar2::stdin_format.compare("qpbo") == 0) {
+            if (check_file_ext(format, file_extension_map["qpbo_ext"]) || ToulBar2::stdin_format.compare("qpbo") == 0) {
                 if (ToulBar2::verbose >= 0)
                     cout << "loading quadratic pseudo-Boolean optimization file:" << problem << endl;
                 ToulBar2::qpbo = true;
@@ -1847,6 +1984,16 @@ int _tmain(int argc, TCHAR* argv[])
                 strfile = problem;
             }
 
+            // binary snapshot file
+
+            if (check_file_ext(problem, file_extension_map["wcspbin_ext"])) {
+                if (ToulBar2::verbose >= 0)
+                    cout << "loading binary snapshot file: " << problem << endl;
+                ToulBar2::wcspbin = true;
+                strext = ".wcspbin";
+                strfile = problem;
+            }
+
             // upperbound file
 
             if (check_file_ext(problem, file_extension_map["ub_ext"])) {
@@ -2132,7 +2279,10 @@ int _tmain(int argc, TCHAR* argv[])
             if (timeout > 0)
                 timer(timeout);
 #endif
-            solver->solve();
+            if (ToulBar2::portfolio > 1 && Portfolio::start(solver))
+                Portfolio::end(solver);
+            else
+                solver->solve();
         }
     } catch (Contradiction) {
         if (ToulBar2::verbose >= 0)
@@ -216,6 +216,7 @@ public:
     virtual void postUnaryConstraint(int xIndex, vector<Cost>& costs) = 0;
     virtual int postBinaryConstraint(int xIndex, int yIndex, vector<Cost>& costs) = 0;
     virtual int postTernaryConstraint(int xIndex, int yIndex, int zIndex, vector<Cost>& costs) = 0;
+    virtual void postQuadraticBooleanFunction(int n, int m, int* posx, int* posy, double* cost, Double multiplier, bool booldom, bool minimize) = 0; ///< \brief create unary and binary cost functions from the nonzero costs of a quadratic function on Boolean variables 0 to n-1, merging the costs on the same pair of variables (see WCSP::read_qpbo)
     virtual int postNaryConstraintBegin(int* scope, int arity, Cost defval, Long nbtuples = 0) = 0; /// \warning must call WeightedCSP::postNaryConstraintEnd after giving cost tuples
     virtual void postNaryConstraintTuple(int ctrindex, Value* tuple, int arity, Cost cost) = 0;
     virtual void postNaryConstraintEnd(int ctrindex) = 0; /// \warning must call WeightedCSP::sortConstraints after all cost functions have been posted (see WeightedCSP::sortConstraints)
@@ -365,6 +366,7 @@ public:
     virtual void read_random(int n, int m, vector<int>& p, int seed, bool forceSubModular = false, string globalname = "") = 0; ///< \brief create a random WCSP with \e n variables, domain size \e m, array \e p where the first element is a percentage of tuples with a nonzero cost and next elements are the number of random cost functions for each different arity (starting with arity two), random seed, a flag to have a percentage (last element in the array \e p) of the binary cost functions being permutated submodular, and a string to use a specific global cost function instead of random cost functions in extension
     virtual void read_wcnf(const char* fileName) = 0; ///< \brief load problem in (w)cnf format (see http://www.maxsat.udl.cat/08/index.php?disp=requirements)
     virtual void read_qpbo(const char* fileName) = 0; ///< \brief load quadratic pseudo-Boolean optimization problem in unconstrained quadratic programming text format (first text line with n, number of variables and m, number of triplets, followed by the m triplets (x,y,cost) describing the sparse symmetric nXn cost matrix with variable indexes such that x <= y and any positive or negative real numbers for costs)
+    virtual void read_wcspbin(const char* fileName) = 0; ///< \brief load problem from a binary snapshot file (see \ref wcspbinformat), mapping it in memory without parsing
 
     virtual const vector<Value>& getSolution(Cost* cost_ptr = NULL) = 0; ///< \brief returns current best solution and its cost
     virtual void setSolution(Cost cost, TAssign* sol = NULL) = 0; ///< \brief set best solution from current assigned values or from a given assignment (for BTD-like methods)
@@ -373,6 +375,7 @@ public:
 
     virtual void print(ostream& os) = 0; ///< \brief print current domains and active cost functions (see \ref verbosity)
     virtual void dump(ostream& os, bool original = true) = 0; ///< \brief output the current WCSP into a file in wcsp format \param os output file \param original if true then keeps all variables with their original domain size else uses unassigned variables and current domains recoding variable indexes
+    virtual void dump_wcspbin(const char* fileName, bool original = true) = 0; ///< \brief output the current WCSP into a binary snapshot file (see \ref wcspbinformat) \param fileName output file name \param original if true then keeps all variables with their original domain size else uses unassigned variables and current domains recoding variable indexes
 
     // -----------------------------------------------------------
     // Functions dealing with all representations of Costs
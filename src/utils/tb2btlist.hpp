@@ -35,13 +35,13 @@ public:
 
 template <class T>
 class BTList {
-    StoreStack<BTList, DLink<T>*>* storeUndo;
+    StoreTrail* storeUndo;
     int size;
     DLink<T>* head;
     DLink<T>* last;
 
 public:
-    BTList(StoreStack<BTList, DLink<T>*>* s)
+    BTList(StoreTrail* s)
         : storeUndo(s)
         , size(0)
         , head(NULL)
@@ -84,7 +84,7 @@ public:
         last = elt;
         last->next = NULL;
         if (backtrack)
-            storeUndo->store(this, NULL);
+            storeUndo->store(this, (DLink<T>*)NULL);
     }
 
     void undoPushBack()
@@ -237,15 +237,16 @@ typedef BTList<Separator*> SeparatorList;
  * 
  */
 
-template <class T, class V>
 template <class Q>
-void StoreStack<T, V>::restore(BTList<Q>** l, DLink<Q>** elt, ptrdiff_t& x)
+void StoreTrail::restoreList(ptrdiff_t& x)
 {
-    if (elt[x] == NULL) {
-        l[x]->undoPushBack();
+    BTList<Q>* l = (BTList<Q>*)addresses[x];
+    DLink<Q>* elt = (DLink<Q>*)(intptr_t)contents[x];
+    if (elt == NULL) {
+        l->undoPushBack();
     } else {
-        assert(l[x] == l[x - 1]);
-        l[x]->undoErase(elt[x], elt[x - 1]);
+        assert(addresses[x - 1] == l && tags[x - 1] == tags[x]);
+        l->undoErase(elt, (DLink<Q>*)(intptr_t)contents[x - 1]);
         x--;
     }
 }
@@ -17,7 +17,7 @@ class BTQueue : public BTList<Variable*> {
     BTQueue& operator=(const BTQueue& s);
 
 public:
-    BTQueue(StoreStack<BTList<Variable*>, DLink<Variable*>*>* sv)
+    BTQueue(StoreTrail* sv)
         : BTList<Variable*>(sv)
     {
     }
@@ -0,0 +1,199 @@
+/*
+ * **************** Transparent decompression of input files and compression of output files **************************
+ *
+ */
+
+#include "tb2compression.hpp"
+
+#ifdef BOOST
+#include <boost/version.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#if (BOOST_VERSION >= 106500)
+#include <boost/iostreams/filter/lzma.hpp>
+#define BOOST_LZMA
+#endif
+#if (BOOST_VERSION >= 107000)
+#include <boost/iostreams/filter/zstd.hpp>
+#define BOOST_ZSTD
+#endif
+#endif
+
+static const char* compressionNames[] = { "none", "gzip", "xz", "zstd" };
+static const char* compressionSuffixes[] = { "", ".gz", ".xz", ".zst" };
+
+Compression compressionFromMagic(const char* header, size_t size)
+{
+    if (size >= 2 && (unsigned char)header[0] == 0x1f && (unsigned char)header[1] == 0x8b)
+        return COMPRESSION_GZIP;
+    if (size >= 6 && memcmp(header, "\xfd\x37\x7a\x58\x5a\x00", 6) == 0)
+        return COMPRESSION_XZ;
+    if (size >= 4 && memcmp(header, "\x28\xb5\x2f\xfd", 4) == 0)
+        return COMPRESSION_ZSTD;
+    return COMPRESSION_NONE;
+}
+
+Compression compressionFromName(const string& fileName)
+{
+    for (int c = COMPRESSION_GZIP; c <= COMPRESSION_ZSTD; c++) {
+        size_t len = strlen(compressionSuffixes[c]);
+        if (fileName.size() > len && fileName.compare(fileName.size() - len, len, compressionSuffixes[c]) == 0)
+            return (Compression)c;
+    }
+    return COMPRESSION_NONE;
+}
+
+string uncompressedName(const string& fileName)
+{
+    Compression c = compressionFromName(fileName);
+    return fileName.substr(0, fileName.size() - strlen(compressionSuffixes[c]));
+}
+
+#ifdef BOOST
+// Pushes the decompressor or compressor of a given format, returns false if not available
+template <typename Mode>
+static bool pushFilter(boost::iostreams::filtering_streambuf<Mode>& buf, Compression compression, bool decompress)
+{
+    switch (compression) {
+    case COMPRESSION_GZIP:
+        if (decompress)
+            buf.push(boost::iostreams::gzip_decompressor());
+        else
+            buf.push(boost::iostreams::gzip_compressor());
+        return true;
+#ifdef BOOST_LZMA
+    case COMPRESSION_XZ:
+        if (decompress)
+            buf.push(boost::iostreams::lzma_decompressor());
+        else
+            buf.push(boost::iostreams::lzma_compressor());
+        return true;
+#endif
+#ifdef BOOST_ZSTD
+    case COMPRESSION_ZSTD:
+        if (decompress)
+            buf.push(boost::iostreams::zstd_decompressor());
+        else
+            buf.push(boost::iostreams::zstd_compressor());
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+#endif
+
+// Stream buffer giving back the first bytes already read from another stream buffer (the standard input cannot be rewound)
+class PeekedStreambuf : public std::streambuf {
+    std::streambuf* source;
+    char buffer[1 << 16];
+
+public:
+    PeekedStreambuf(std::streambuf* src, const char* header, size_t size)
+        : source(src)
+    {
+        assert(size <= sizeof(buffer));
+        memcpy(buffer, header, size);
+        setg(buffer, buffer, buffer + size);
+    }
+
+protected:
+    int_type underflow()
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        streamsize nread = source->sgetn(buffer, sizeof(buffer));
+        if (nread <= 0)
+            return traits_type::eof();
+        setg(buffer, buffer, buffer + nread);
+        return traits_type::to_int_type(*gptr());
+    }
+};
+
+CompressedInput::CompressedInput(const char* fileName)
+    : peeked(NULL)
+    , input(NULL)
+    , compression(COMPRESSION_NONE)
+    , opened(false)
+{
+    const size_t magicSize = 6;
+    char magic[magicSize];
+    size_t size = 0;
+    if (fileName) {
+        file.open(fileName, std::ios_base::in | std::ios_base::binary);
+        if (!file)
+            return;
+        file.read(magic, magicSize);
+        size = file.gcount();
+        file.clear();
+        file.seekg(0);
+    } else {
+        streamsize nread = cin.rdbuf()->sgetn(magic, magicSize);
+        size = ((nread > 0) ? nread : 0);
+        peeked = new PeekedStreambuf(cin.rdbuf(), magic, size);
+    }
+    compression = compressionFromMagic(magic, size);
+    std::streambuf* source = ((peeked) ? peeked : file.rdbuf());
+    if (compression == COMPRESSION_NONE) {
+        input.rdbuf(source);
+        opened = true;
+        return;
+    }
+#ifdef BOOST
+    if (pushFilter(inbuf, compression, true)) {
+        inbuf.push(*source);
+        input.rdbuf(&inbuf);
+        opened = true;
+        return;
+    }
+#endif
+    cerr << "Error: " << compressionNames[compression] << " compressed input";
+    if (fileName)
+        cerr << " file '" << fileName << "'";
+    cerr << " not supported (compiling with a Boost iostreams library supporting this format is needed)." << endl;
+    exit(EXIT_FAILURE);
+}
+
+CompressedInput::~CompressedInput()
+{
+#ifdef BOOST
+    if (!inbuf.empty())
+        inbuf.reset();
+#endif
+    delete peeked;
+}
+
+CompressedOutput::CompressedOutput(const char* fileName)
+    : output(NULL)
+    , compression(compressionFromName(fileName))
+{
+    file.open(fileName, std::ios_base::out | std::ios_base::binary);
+    if (compression == COMPRESSION_NONE) {
+        output.rdbuf(file.rdbuf());
+        return;
+    }
+#ifdef BOOST
+    if (pushFilter(outbuf, compression, false)) {
+        outbuf.push(file);
+        output.rdbuf(&outbuf);
+        return;
+    }
+#endif
+    cerr << "Error: " << compressionNames[compression] << " compressed output file '" << fileName << "' not supported (compiling with a Boost iostreams library supporting this format is needed)." << endl;
+    exit(EXIT_FAILURE);
+}
+
+CompressedOutput::~CompressedOutput()
+{
+    output.flush();
+#ifdef BOOST
+    if (!outbuf.empty())
+        outbuf.reset(); // closes the compressor
+#endif
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
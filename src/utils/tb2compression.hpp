@@ -0,0 +1,79 @@
+/** \file tb2compression.hpp
+ *  \brief Transparent decompression of problem files and compression of dumped problems.
+ *
+ *  Input files (or the standard input) compressed by gzip, xz or zstd are recognized by their first bytes and decompressed on the fly.
+ *  Output files are compressed depending on their suffix (.gz, .xz or .zst).
+ *  Compression formats other than gzip depend on the Boost iostreams library they were compiled with.
+ */
+
+#ifndef TB2COMPRESSION_HPP_
+#define TB2COMPRESSION_HPP_
+
+#include "core/tb2types.hpp"
+
+#ifdef BOOST
+#include <boost/iostreams/filtering_streambuf.hpp>
+#endif
+
+enum Compression {
+    COMPRESSION_NONE,
+    COMPRESSION_GZIP,
+    COMPRESSION_XZ,
+    COMPRESSION_ZSTD
+};
+
+/// \return compression format given by the magic number at the beginning of a file
+Compression compressionFromMagic(const char* header, size_t size);
+/// \return compression format given by the suffix of a file name
+Compression compressionFromName(const string& fileName);
+/// \return file name without its compression suffix (if any)
+string uncompressedName(const string& fileName);
+
+/// \brief input stream on a file or the standard input, decompressed on the fly if needed
+class CompressedInput {
+    ifstream file;
+    std::streambuf* peeked; // standard input with its first bytes read again
+#ifdef BOOST
+    boost::iostreams::filtering_streambuf<boost::iostreams::input> inbuf;
+#endif
+    istream input;
+    Compression compression;
+    bool opened;
+
+public:
+    /// \param fileName input file name or NULL for the standard input
+    CompressedInput(const char* fileName);
+    ~CompressedInput();
+
+    bool good() const { return opened; }
+    istream& stream() { return input; }
+    Compression getCompression() const { return compression; }
+    /// \brief true if reading an uncompressed regular file (which can be mapped in memory)
+    bool isPlainFile() const { return opened && compression == COMPRESSION_NONE && peeked == NULL; }
+};
+
+/// \brief output stream on a file, compressed depending on the suffix of its name
+class CompressedOutput {
+    ofstream file;
+#ifdef BOOST
+    boost::iostreams::filtering_streambuf<boost::iostreams::output> outbuf;
+#endif
+    ostream output;
+    Compression compression;
+
+public:
+    CompressedOutput(const char* fileName);
+    ~CompressedOutput(); ///< \brief flushes the compressed stream and writes its trailer
+
+    bool good() const { return file.good(); }
+    ostream& stream() { return output; }
+};
+
+#endif /*TB2COMPRESSION_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
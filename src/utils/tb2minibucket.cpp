@@ -0,0 +1,438 @@
+/*
+ * **************** Mini-bucket elimination with dense cost tables in a flat arena **************************
+ *
+ */
+
+#include "core/tb2wcsp.hpp"
+#include "core/tb2enumvar.hpp"
+#include "core/tb2binconstr.hpp"
+#include "core/tb2ternaryconstr.hpp"
+
+#ifdef LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+/**
+ * \defgroup minibucket Mini-bucket elimination
+ *
+ * Mini-bucket elimination (option -mbe=i) is performed in preprocessing on the current problem after initial propagation,
+ * following the variable elimination order given by option -O or else a minimum fill-in order.
+ * Each cost function is put in the bucket of its first eliminated variable. When a variable is eliminated, the cost functions of its bucket
+ * are partitioned (largest scopes first) into mini-buckets having at most i variables and whose resulting cost table fits in the remaining memory.
+ * Each mini-bucket produces a new cost function, the minimum over the eliminated variable of the sum of its cost functions, which is put in the bucket of its next eliminated variable.
+ * The sum of the resulting constant costs is a lower bound of the optimum, which is exact if no bucket has been split.
+ * An assignment is then built greedily in the reverse elimination order using the cost functions of each bucket, giving an upper bound (an optimal solution if exact).
+ *
+ * All cost tables are dense (the first eliminated variable of their scope varying the fastest) and allocated one after the other in a flat arena made of
+ * a memory region of -mbemem=MB reserved once (pages are only allocated when used) followed by an optional scratch file of -mbespill=MB mapped in memory (created in TMPDIR or /tmp and immediately unlinked).
+ * Tables in the scratch file can be written back to disk by the operating system when memory is short, allowing intermediate tables larger than the available RAM.
+ *
+ * \warning Interval variables are not supported. Cost functions which are not binary or ternary are enumerated over the current domains.
+ */
+
+/// bump allocator of cost tables inside a region reserved once, either in anonymous memory or in a memory-mapped scratch file
+class MBArena {
+    char* base;
+    size_t capacity;
+    size_t used;
+
+public:
+    MBArena()
+        : base(NULL)
+        , capacity(0)
+        , used(0)
+    {
+    }
+
+    ~MBArena()
+    {
+        if (base) {
+#ifdef LINUX
+            munmap(base, capacity);
+#else
+            free(base);
+#endif
+        }
+    }
+
+    /// \brief reserves \a size bytes in memory or in a scratch file if \a scratch is true
+    /// \return false if the region cannot be reserved
+    bool reserve(size_t size, bool scratch)
+    {
+        assert(!base);
+        if (size == 0)
+            return true;
+#ifdef LINUX
+        int fd = -1;
+        if (scratch) {
+            const char* dir = getenv("TMPDIR");
+            string path = string((dir && dir[0]) ? dir : "/tmp") + "/toulbar2_mbe_XXXXXX";
+            vector<char> name(path.begin(), path.end());
+            name.push_back('\0');
+            fd = mkstemp(name.data());
+            if (fd < 0)
+                return false;
+            unlink(name.data()); // the file disappears when unmapped
+            if (ftruncate(fd, size) != 0) {
+                close(fd);
+                return false;
+            }
+        }
+        void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, (scratch) ? MAP_SHARED : (MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE), fd, 0);
+        if (fd >= 0)
+            close(fd);
+        if (mem == MAP_FAILED)
+            return false;
+        base = (char*)mem;
+#else
+        if (scratch)
+            return false;
+        base = (char*)malloc(size);
+        if (!base)
+            return false;
+#endif
+        capacity = size;
+        return true;
+    }
+
+    size_t available() const { return capacity - used; }
+    size_t getUsed() const { return used; }
+
+    /// \brief returns a table of \a n costs or NULL if there is not enough space left
+    Cost* allocate(size_t n)
+    {
+        size_t bytes = n * sizeof(Cost);
+        if (bytes > available())
+            return NULL;
+        Cost* table = (Cost*)(base + used);
+        used += bytes;
+        return table;
+    }
+};
+
+/// dense cost table over variables given by their position in the elimination order
+struct MBFunction {
+    vector<int> scope; ///< decreasing positions (the last variable is eliminated first and varies the fastest)
+    Cost* costs;
+};
+
+Cost WCSP::miniBucketElimination(vector<int>& varIndexes, vector<Value>& values)
+{
+    double startTime = cpuTime();
+    varIndexes.clear();
+    values.clear();
+    Cost ub = getUb();
+    Cost lb = getLb();
+    for (unsigned int i = 0; i < vars.size(); i++) {
+        if (vars[i]->unassigned() && !vars[i]->enumerated()) {
+            if (ToulBar2::verbose >= 0)
+                cout << "Warning! Mini-bucket elimination skipped due to interval variables." << endl;
+            return lb;
+        }
+    }
+
+    // variables in elimination order (order[0] is eliminated first)
+    vector<int> order;
+    if (ToulBar2::varOrder) {
+        elimOrderFile2Vector(ToulBar2::varOrder, order);
+    } else {
+#ifdef BOOST
+        minimumFillInOrdering(order);
+#else
+        for (int i = numberOfVariables() - 1; i >= 0; i--)
+            order.push_back(i);
+#endif
+    }
+    vector<int> position(vars.size(), -1);
+    vector<EnumeratedVariable*> evars;
+    for (unsigned int i = 0; i < order.size(); i++) {
+        if (vars[order[i]]->unassigned() && position[order[i]] < 0) {
+            position[order[i]] = evars.size();
+            evars.push_back((EnumeratedVariable*)vars[order[i]]);
+        }
+    }
+    int n = evars.size();
+    if (n == 0)
+        return lb;
+    vector<vector<Value>> domains(n);
+    vector<vector<int>> currentIndex(n); // position in the current domain of every initial value index
+    for (int p = 0; p < n; p++) {
+        currentIndex[p].assign(evars[p]->getDomainInitSize(), -1);
+        for (EnumeratedVariable::iterator iter = evars[p]->begin(); iter != evars[p]->end(); ++iter) {
+            currentIndex[p][evars[p]->toIndex(*iter)] = domains[p].size();
+            domains[p].push_back(*iter);
+        }
+    }
+    auto tableSize = [&domains](const vector<int>& scope, size_t first, size_t last) {
+        Double size = 1.;
+        for (size_t k = first; k < last; k++)
+            size *= domains[scope[k]].size();
+        return size;
+    };
+
+    MBArena memory, scratch;
+    if (!memory.reserve((size_t)ToulBar2::miniBucketMaxMB * 1024 * 1024, false)) {
+        cerr << "Error: cannot reserve " << ToulBar2::miniBucketMaxMB << " MB of memory for mini-bucket elimination!" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (ToulBar2::miniBucketSpillMB > 0 && !scratch.reserve((size_t)ToulBar2::miniBucketSpillMB * 1024 * 1024, true)) {
+        cerr << "Warning! Cannot create a scratch file of " << ToulBar2::miniBucketSpillMB << " MB for mini-bucket elimination." << endl;
+    }
+    // checks that a sequence of tables can be allocated in memory first and then in the scratch file
+    // (using at most half of the remaining space if \a merge is true, to keep room for the next eliminations)
+    auto fits = [&memory, &scratch](const vector<Double>& sizes, bool merge) {
+        Double left = memory.available() / ((merge) ? 2. : 1.);
+        Double spill = scratch.available() / ((merge) ? 2. : 1.);
+        for (vector<Double>::const_iterator s = sizes.begin(); s != sizes.end(); ++s) {
+            Double bytes = *s * sizeof(Cost);
+            if (bytes <= left)
+                left -= bytes;
+            else if (bytes <= spill)
+                spill -= bytes;
+            else
+                return false;
+        }
+        return true;
+    };
+    auto allocate = [&memory, &scratch](size_t size) {
+        Cost* table = memory.allocate(size);
+        return (table) ? table : scratch.allocate(size);
+    };
+    auto skip = [&lb](const char* reason) {
+        if (ToulBar2::verbose >= 0)
+            cout << "Warning! Mini-bucket elimination skipped: " << reason << "." << endl;
+        return lb;
+    };
+
+    // dense tables of the unary and connected cost functions, put in the bucket of their first eliminated variable
+    vector<MBFunction> functions;
+    vector<vector<int>> buckets(n);
+    Cost constant = MIN_COST;
+    for (int p = 0; p < n; p++) {
+        MBFunction f;
+        f.scope.push_back(p);
+        f.costs = allocate(domains[p].size());
+        if (!f.costs)
+            return skip("not enough memory");
+        for (unsigned int a = 0; a < domains[p].size(); a++)
+            f.costs[a] = min(ub, evars[p]->getCost(domains[p][a]));
+        buckets[p].push_back(functions.size());
+        functions.push_back(f);
+    }
+    vector<Constraint*> ctrs;
+    for (unsigned int i = 0; i < constrs.size(); i++)
+        if (constrs[i]->connected() && !constrs[i]->isSep())
+            ctrs.push_back(constrs[i]);
+    for (int i = 0; i < elimBinOrder; i++)
+        if (elimBinConstrs[i]->connected() && !elimBinConstrs[i]->isSep())
+            ctrs.push_back(elimBinConstrs[i]);
+    for (int i = 0; i < elimTernOrder; i++)
+        if (elimTernConstrs[i]->connected() && !elimTernConstrs[i]->isSep())
+            ctrs.push_back(elimTernConstrs[i]);
+    for (vector<Constraint*>::iterator it = ctrs.begin(); it != ctrs.end(); ++it) {
+        Constraint* ctr = *it;
+        int arity = ctr->arity();
+        MBFunction f;
+        for (int i = 0; i < arity; i++)
+            if (ctr->getVar(i)->unassigned())
+                f.scope.push_back(position[ctr->getVar(i)->wcspIndex]);
+        sort(f.scope.begin(), f.scope.end(), greater<int>());
+        Double size = tableSize(f.scope, 0, f.scope.size());
+        if (!fits(vector<Double>(1, size), false))
+            return skip("not enough memory");
+        f.costs = allocate((size_t)size);
+        // stride in the table of every variable of the cost function (zero if assigned)
+        vector<size_t> stride(arity, 0);
+        for (int i = 0; i < arity; i++) {
+            if (ctr->getVar(i)->unassigned()) {
+                int k = find(f.scope.begin(), f.scope.end(), position[ctr->getVar(i)->wcspIndex]) - f.scope.begin();
+                stride[i] = (size_t)tableSize(f.scope, k + 1, f.scope.size());
+            }
+        }
+        if (ctr->isBinary()) {
+            BinaryConstraint* bctr = (BinaryConstraint*)ctr;
+            EnumeratedVariable* x = (EnumeratedVariable*)bctr->getVar(0);
+            EnumeratedVariable* y = (EnumeratedVariable*)bctr->getVar(1);
+            size_t a = 0;
+            for (EnumeratedVariable::iterator iterX = x->begin(); iterX != x->end(); ++iterX, a += stride[0]) {
+                size_t b = a;
+                for (EnumeratedVariable::iterator iterY = y->begin(); iterY != y->end(); ++iterY, b += stride[1]) {
+                    f.costs[b] = min(ub, bctr->getCost(x, y, *iterX, *iterY));
+                }
+            }
+        } else if (ctr->isTernary()) {
+            TernaryConstraint* tctr = (TernaryConstraint*)ctr;
+            EnumeratedVariable* x = (EnumeratedVariable*)tctr->getVar(0);
+            EnumeratedVariable* y = (EnumeratedVariable*)tctr->getVar(1);
+            EnumeratedVariable* z = (EnumeratedVariable*)tctr->getVar(2);
+            size_t a = 0;
+            for (EnumeratedVariable::iterator iterX = x->begin(); iterX != x->end(); ++iterX, a += stride[0]) {
+                size_t b = a;
+                for (EnumeratedVariable::iterator iterY = y->begin(); iterY != y->end(); ++iterY, b += stride[1]) {
+                    size_t c = b;
+                    for (EnumeratedVariable::iterator iterZ = z->begin(); iterZ != z->end(); ++iterZ, c += stride[2]) {
+                        f.costs[c] = min(ub, tctr->getCost(x, y, z, *iterX, *iterY, *iterZ));
+                    }
+                }
+            }
+        } else {
+            for (size_t a = 0; a < (size_t)size; a++)
+                f.costs[a] = ub;
+            String t;
+            Cost c;
+            ctr->firstlex();
+            while (ctr->nextlex(t, c)) {
+                size_t offset = 0;
+                for (int i = 0; i < arity; i++) {
+                    if (stride[i] > 0) {
+                        int a = currentIndex[position[ctr->getVar(i)->wcspIndex]][t[i] - CHAR_FIRST];
+                        assert(a >= 0);
+                        offset += a * stride[i];
+                    }
+                }
+                f.costs[offset] = min(ub, c);
+            }
+        }
+        if (f.scope.empty()) {
+            constant = min(ub, constant + f.costs[0]);
+        } else {
+            buckets[f.scope.back()].push_back(functions.size());
+            functions.push_back(f);
+        }
+    }
+
+    // eliminates variables one by one, splitting their bucket into mini-buckets if needed
+    int nbsplit = 0;
+    for (int p = 0; p < n && constant < ub; p++) {
+        vector<int>& bucket = buckets[p];
+        stable_sort(bucket.begin(), bucket.end(), [&functions](int f1, int f2) { return functions[f1].scope.size() > functions[f2].scope.size(); });
+        vector<vector<int>> mbscopes;
+        vector<vector<int>> mbfunctions;
+        vector<Double> sizes; // sizes of the resulting tables
+        for (vector<int>::iterator f = bucket.begin(); f != bucket.end(); ++f) {
+            const vector<int>& scope = functions[*f].scope;
+            assert(scope.back() == p);
+            bool placed = false;
+            for (unsigned int k = 0; !placed && k < mbscopes.size(); k++) {
+                vector<int> scopeUnion;
+                set_union(mbscopes[k].begin(), mbscopes[k].end(), scope.begin(), scope.end(), back_inserter(scopeUnion), greater<int>());
+                if ((int)scopeUnion.size() <= ToulBar2::miniBucket) {
+                    vector<Double> newsizes = sizes;
+                    newsizes[k] = tableSize(scopeUnion, 0, scopeUnion.size() - 1);
+                    if (fits(newsizes, true)) {
+                        mbscopes[k] = scopeUnion;
+                        mbfunctions[k].push_back(*f);
+                        sizes = newsizes;
+                        placed = true;
+                    }
+                }
+            }
+            if (!placed) {
+                mbscopes.push_back(scope);
+                mbfunctions.push_back(vector<int>(1, *f));
+                sizes.push_back(tableSize(scope, 0, scope.size() - 1));
+                if (!fits(sizes, false))
+                    return skip("not enough memory");
+            }
+        }
+        if (mbscopes.size() > 1)
+            nbsplit++;
+
+        // computes the minimum over the eliminated variable of the sum of the cost functions of each mini-bucket
+        size_t dx = domains[p].size();
+        vector<Cost> row(dx);
+        for (unsigned int k = 0; k < mbscopes.size(); k++) {
+            MBFunction g;
+            g.scope.assign(mbscopes[k].begin(), mbscopes[k].end() - 1);
+            size_t size = (size_t)sizes[k];
+            g.costs = allocate(size);
+            assert(g.costs);
+            int arity = g.scope.size();
+            const vector<int>& mbf = mbfunctions[k];
+            // stride of every output variable in every input table (zero if absent)
+            vector<size_t> stride(mbf.size() * arity, 0);
+            for (unsigned int j = 0; j < mbf.size(); j++) {
+                const vector<int>& scope = functions[mbf[j]].scope;
+                size_t s = dx;
+                for (int i = scope.size() - 2; i >= 0; i--) {
+                    int l = find(g.scope.begin(), g.scope.end(), scope[i]) - g.scope.begin();
+                    stride[j * arity + l] = s;
+                    s *= domains[scope[i]].size();
+                }
+            }
+            vector<size_t> offset(mbf.size(), 0);
+            vector<unsigned int> tuple(arity, 0);
+            for (size_t s = 0; s < size; s++) {
+                for (size_t a = 0; a < dx; a++)
+                    row[a] = MIN_COST;
+                for (unsigned int j = 0; j < mbf.size(); j++) {
+                    const Cost* costs = functions[mbf[j]].costs + offset[j];
+                    for (size_t a = 0; a < dx; a++)
+                        row[a] = min(ub, row[a] + costs[a]);
+                }
+                Cost best = ub;
+                for (size_t a = 0; a < dx; a++)
+                    best = min(best, row[a]);
+                g.costs[s] = best;
+                // next tuple, the last variable varying the fastest
+                for (int l = arity - 1; l >= 0; l--) {
+                    for (unsigned int j = 0; j < mbf.size(); j++)
+                        offset[j] += stride[j * arity + l];
+                    if (++tuple[l] < domains[g.scope[l]].size())
+                        break;
+                    for (unsigned int j = 0; j < mbf.size(); j++)
+                        offset[j] -= tuple[l] * stride[j * arity + l];
+                    tuple[l] = 0;
+                }
+            }
+            if (g.scope.empty()) {
+                constant = min(ub, constant + g.costs[0]);
+            } else {
+                buckets[g.scope.back()].push_back(functions.size());
+                functions.push_back(g);
+            }
+        }
+    }
+    Cost bound = min(ub, lb + constant);
+
+    if (bound < ub) {
+        // greedy assignment in reverse elimination order using the cost functions of each bucket
+        vector<unsigned int> solution(n, 0);
+        for (int p = n - 1; p >= 0; p--) {
+            size_t dx = domains[p].size();
+            vector<Cost> row(dx, MIN_COST);
+            for (vector<int>::iterator f = buckets[p].begin(); f != buckets[p].end(); ++f) {
+                const vector<int>& scope = functions[*f].scope;
+                size_t offset = 0;
+                size_t s = dx;
+                for (int i = scope.size() - 2; i >= 0; i--) {
+                    offset += solution[scope[i]] * s;
+                    s *= domains[scope[i]].size();
+                }
+                const Cost* costs = functions[*f].costs + offset;
+                for (size_t a = 0; a < dx; a++)
+                    row[a] = min(ub, row[a] + costs[a]);
+            }
+            solution[p] = min_element(row.begin(), row.end()) - row.begin();
+        }
+        for (int p = 0; p < n; p++) {
+            varIndexes.push_back(evars[p]->wcspIndex);
+            values.push_back(domains[p][solution[p]]);
+        }
+    }
+
+    if (ToulBar2::verbose >= 0) {
+        cout << "Mini-bucket elimination (i-bound " << ToulBar2::miniBucket << ") lower bound: " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << Cost2ADCost(bound) << std::setprecision(DECIMAL_POINT);
+        if (nbsplit > 0)
+            cout << " (" << nbsplit << " split buckets)";
+        else
+            cout << " (exact)";
+        cout << " using " << memory.getUsed() / 1024. / 1024. << " MB in memory";
+        if (scratch.getUsed() > 0)
+            cout << " and " << scratch.getUsed() / 1024. / 1024. << " MB in scratch file";
+        cout << " in " << cpuTime() - startTime << " seconds." << endl;
+    }
+    return bound;
+}
@@ -12,6 +12,16 @@
 #include "tb2randomgen.hpp"
 #include "core/tb2globaldecomposable.hpp"
 #include "core/tb2clqcover.hpp"
+#include "tb2threads.hpp"
+#include "tb2compression.hpp"
+
+#ifdef LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <unordered_map>
 
 typedef struct {
     EnumeratedVariable* var;
@@ -278,6 +288,7 @@ public:
     ~CFNStreamReader();
 
     std::pair<int, string> getNextToken();
+    int getNextToken(const char*& token, size_t& length); // token is only valid until the next read
     void skipOBrace(); // checks if next token is an opening brace and spits an error otherwise.
     void skipCBrace(); // checks if next token is a  closing brace and spits an error otherwise.
     void testJSONTag(const std::pair<int, string>& token, const string& tag);
@@ -291,6 +302,8 @@ public:
     unsigned readVariable(unsigned int varIndex);
     int readDomain(std::vector<string>& valueNames);
     int getValueIdx(int variableIdx, const string& token, int lineNumber);
+    int getValueIdx(int variableIdx, const char* token, size_t length, int lineNumber);
+    Cost getCost(const char* token, size_t length, int lineNumber);
     void readScope(vector<int>& scope);
     pair<unsigned, unsigned> readCostFunctions();
     void readZeroAryCostFunction(bool all, Cost defaultCost);
@@ -315,23 +328,56 @@ public:
 private:
     istream& iStream;
     WCSP* wcsp;
-    bool getNextLine();
+    bool fillBuffer();
+    bool skipLine();
+    vector<char> buffer; // large chunks of the input stream
+    size_t bufferKeep; // unread characters (or the token being scanned) start here when the buffer is refilled
+    size_t bufferPos; // next character to scan
+    size_t bufferEnd;
+    bool endOfStream;
+    bool lineStart; // true if no character has been scanned yet on the current line
     unsigned int lineCount;
-    string currentLine;
-    boost::char_separator<char> sep;
-    boost::tokenizer<boost::char_separator<char> >* tok;
-    boost::tokenizer<boost::char_separator<char> >::iterator tok_iter;
     bool JSONMode;
 };
 
+// Character classes of the CFN tokenizer: separators are dropped, braces are single character tokens
+enum CFNCharClass {
+    CFN_TOKEN = 0,
+    CFN_SEPARATOR,
+    CFN_BRACE,
+    CFN_NEWLINE,
+    CFN_SLASH
+};
+
+static const size_t CFN_BUFFER_SIZE = 1 << 20;
+
+struct CFNCharClasses {
+    unsigned char table[256];
+    CFNCharClasses()
+    {
+        memset(table, CFN_TOKEN, sizeof(table));
+        for (const char* c = " \f\r\t\":,"; *c; c++)
+            table[(unsigned char)*c] = CFN_SEPARATOR;
+        for (const char* c = "{}[]"; *c; c++)
+            table[(unsigned char)*c] = CFN_BRACE;
+        table[(unsigned char)'\n'] = CFN_NEWLINE;
+        table[(unsigned char)'/'] = CFN_SLASH;
+    }
+};
+static const CFNCharClasses cfnCharClasses;
+
 CFNStreamReader::CFNStreamReader(istream& stream, WCSP* wcsp)
     : iStream(stream)
     , wcsp(wcsp)
 {
-    this->lineCount = 0;
+    this->buffer.resize(CFN_BUFFER_SIZE);
+    this->bufferKeep = 0;
+    this->bufferPos = 0;
+    this->bufferEnd = 0;
+    this->endOfStream = false;
+    this->lineStart = true;
+    this->lineCount = 1;
     this->JSONMode = false;
-    this->tok = nullptr;
-    this->sep = boost::char_separator<char>(" \n\f\r\t\":,", "{}[]");
     Cost upperBound = readHeader();
     if (ToulBar2::costThresholdS.size())
         ToulBar2::costThreshold = wcsp->decimalToCost(ToulBar2::costThresholdS, 0);
@@ -390,54 +436,146 @@ CFNStreamReader::CFNStreamReader(istream& stream, WCSP* wcsp)
         cout << "Read " << nvar << " variables, with " << nval << " values at most, and " << ncf << " cost functions, with maximum arity " << maxarity << "." << endl;
 }
 
-// Reads a line. Skips comment lines starting with '#' and // too.
-bool CFNStreamReader::getNextLine()
+// Reads the next chunk of the stream, keeping unread characters from bufferKeep at the beginning of the buffer.
+// Returns false if no more characters are available.
+bool CFNStreamReader::fillBuffer()
 {
-    string line;
-    lineCount++;
-    std::getline(iStream, line);
+    if (endOfStream)
+        return false;
+    size_t kept = bufferEnd - bufferKeep;
+    if (kept > 0 && bufferKeep > 0)
+        memmove(&buffer[0], &buffer[bufferKeep], kept);
+    bufferPos -= bufferKeep;
+    bufferKeep = 0;
+    if (kept + CFN_BUFFER_SIZE / 2 > buffer.size()) // very long token
+        buffer.resize(2 * buffer.size());
+    iStream.read(&buffer[kept], buffer.size() - kept);
+    size_t nread = iStream.gcount();
+    bufferEnd = kept + nread;
+    if (nread == 0) {
+        endOfStream = true;
+        return false;
+    }
+    return true;
+}
 
-    while (line == "" || line.at(0) == '#') {
-        if (std::getline(iStream, line))
+// Skips the rest of the current line (comments starting with '#' or //), including its end of line.
+// Returns false at the end of the stream.
+bool CFNStreamReader::skipLine()
+{
+    while (true) {
+        if (bufferPos == bufferEnd) {
+            bufferKeep = bufferPos;
+            if (!fillBuffer())
+                return false;
+        }
+        const char* start = &buffer[bufferPos];
+        const char* eol = (const char*)memchr(start, '\n', bufferEnd - bufferPos);
+        if (eol) {
+            bufferPos += eol - start + 1;
             lineCount++;
-        else
-            return false;
-    }
-    size_t posJSONcomments = line.find("//");
-    if (posJSONcomments == string::npos) {
-        this->currentLine = line;
-        return true;
-    } else if (posJSONcomments != 0) {
-        this->currentLine = line.substr(0, posJSONcomments);
-        return true;
-    } else
-        return getNextLine(); // tail recurse
+            lineStart = true;
+            return true;
+        }
+        bufferPos = bufferEnd;
+    }
 }
 
-// Reads a token using lazily updated line by line reads
-std::pair<int, string> CFNStreamReader::getNextToken()
+// Reads a token directly in the read buffer, without any copy.
+// Returns the line number of the token or -1 at the end of the stream (with an empty token).
+int CFNStreamReader::getNextToken(const char*& token, size_t& length)
 {
-    if (tok != nullptr) {
-        if (tok_iter != tok->end()) {
-            string token = *tok_iter;
-            tok_iter = std::next(tok_iter);
-            return make_pair(lineCount, token);
-        } else {
-            delete tok;
-            tok = nullptr;
-            return getNextToken();
+    while (true) {
+        if (bufferPos == bufferEnd) {
+            bufferKeep = bufferPos;
+            if (!fillBuffer()) {
+                token = "";
+                length = 0;
+                return -1;
+            }
+        }
+        char c = buffer[bufferPos];
+        int cls = cfnCharClasses.table[(unsigned char)c];
+        if (cls == CFN_NEWLINE) {
+            bufferPos++;
+            lineCount++;
+            lineStart = true;
+            continue;
         }
-    } else {
-        if (this->getNextLine()) {
-            tok = new boost::tokenizer<boost::char_separator<char> >(currentLine, sep);
-            tok_iter = tok->begin();
-            return getNextToken();
-        } else {
-            return make_pair(-1, "");
+        if (lineStart && c == '#') {
+            if (!skipLine()) {
+                token = "";
+                length = 0;
+                return -1;
+            }
+            continue;
+        }
+        lineStart = false;
+        if (cls == CFN_SEPARATOR) {
+            bufferPos++;
+            continue;
+        }
+        if (cls == CFN_BRACE) {
+            token = &buffer[bufferPos];
+            length = 1;
+            bufferPos++;
+            return lineCount;
+        }
+        // scans a token until a separator, a brace, an end of line or a // comment
+        bufferKeep = bufferPos;
+        size_t pos = bufferPos;
+        while (true) {
+            if (pos == bufferEnd) {
+                bufferPos = pos;
+                fillBuffer();
+                pos = bufferPos;
+                if (pos == bufferEnd)
+                    break;
+            }
+            cls = cfnCharClasses.table[(unsigned char)buffer[pos]];
+            if (cls == CFN_TOKEN) {
+                pos++;
+                continue;
+            }
+            if (cls == CFN_SLASH) {
+                if (pos + 1 == bufferEnd) {
+                    bufferPos = pos;
+                    fillBuffer();
+                    pos = bufferPos;
+                }
+                if (pos + 1 == bufferEnd || buffer[pos + 1] != '/') {
+                    pos++;
+                    continue;
+                }
+            }
+            break;
+        }
+        size_t start = bufferKeep;
+        bufferPos = pos;
+        bufferKeep = pos;
+        if (pos == start) { // a comment starting with //
+            if (!skipLine()) {
+                token = "";
+                length = 0;
+                return -1;
+            }
+            continue;
         }
+        token = &buffer[start];
+        length = pos - start;
+        return lineCount;
     }
 }
 
+// Reads a token and returns it with its line number (-1 at the end of the stream)
+std::pair<int, string> CFNStreamReader::getNextToken()
+{
+    const char* token;
+    size_t length;
+    int line = getNextToken(token, length);
+    return make_pair(line, string(token, length));
+}
+
 CFNStreamReader::~CFNStreamReader()
 {
     // TODO clear vectors / maps
@@ -703,7 +841,8 @@ void CFNStreamReader::readIntervalUnaryTable(int varIdx, vector<Value>& authoriz
 std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool all, Cost defaultCost, Cost& minCost)
 {
     int lineNumber;
-    string token;
+    const char* token;
+    size_t length;
     minCost = MAX_COST;
 
     if (CUT(defaultCost, wcsp->getUb()) && (defaultCost < MEDIUM_COST * wcsp->getUb()) && wcsp->getUb() < (MAX_COST / MEDIUM_COST))
@@ -718,17 +857,17 @@ std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool
     costVector.resize(costVecSize);
     fill(costVector.begin(), costVector.end(), defaultCost);
 
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token, length);
     if (!all) { // will be a tuple:cost table
         int arity = scope.size();
         int scopeIdx = 0; // position in the scope
         int tableIdx = 0; // position in the cost table
         unsigned long int nbCostInserted = 0;
 
-        while (!isCBrace(token)) {
+        while (!(length == 1 && (*token == '}' || *token == ']'))) {
             // if we have read a full tuple and cost
             if (scopeIdx == arity) {
-                Cost cost = wcsp->decimalToCost(token, lineNumber);
+                Cost cost = getCost(token, length, lineNumber);
                 if (CUT(cost, wcsp->getUb()) && (cost < MEDIUM_COST * wcsp->getUb()) && wcsp->getUb() < (MAX_COST / MEDIUM_COST))
                     cost *= MEDIUM_COST;
                 // the same tuple has already been defined.
@@ -748,7 +887,7 @@ std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool
                 if (scopeIdx != 0) {
                     tableIdx *= wcsp->getDomainInitSize(scope[scopeIdx]);
                 }
-                unsigned int valueIdx = getValueIdx(scope[scopeIdx], token, lineNumber);
+                unsigned int valueIdx = getValueIdx(scope[scopeIdx], token, length, lineNumber);
                 assert(valueIdx >= 0 && valueIdx < wcsp->getDomainInitSize(scope[scopeIdx]));
                 tableIdx += valueIdx;
             }
@@ -758,7 +897,7 @@ std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool
             } else {
                 scopeIdx++;
             }
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token, length);
         }
 
         if (nbCostInserted < costVecSize) // there are some defaultCost remaining
@@ -768,7 +907,7 @@ std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool
     else {
         unsigned int tableIdx = 0;
         while (tableIdx < costVecSize) {
-            Cost cost = wcsp->decimalToCost(token, lineNumber);
+            Cost cost = getCost(token, length, lineNumber);
 
             if (CUT(cost, wcsp->getUb()) && (cost < MEDIUM_COST * wcsp->getUb()) && wcsp->getUb() < (MAX_COST / MEDIUM_COST))
                 cost *= MEDIUM_COST;
@@ -778,7 +917,7 @@ std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool
             costVector[tableIdx] = cost;
             tableIdx++;
 
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token, length);
         }
         if (tableIdx != costVecSize) {
             cerr << "Error: incorrect number of costs in cost table ending at line " << lineNumber << endl;
@@ -851,6 +990,62 @@ int CFNStreamReader::getValueIdx(int variableIdx, const string& token, int lineN
     }
 }
 
+// Returns the index of a value given directly in the read buffer (parsed in place if it is a number)
+int CFNStreamReader::getValueIdx(int variableIdx, const char* token, size_t length, int lineNumber)
+{
+    if (length == 0 || length > 9)
+        return getValueIdx(variableIdx, string(token, length), lineNumber);
+    int valueIdx = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (token[i] < '0' || token[i] > '9')
+            return getValueIdx(variableIdx, string(token, length), lineNumber);
+        valueIdx = 10 * valueIdx + (token[i] - '0');
+    }
+    if ((unsigned)valueIdx >= wcsp->getDomainInitSize(variableIdx))
+        return getValueIdx(variableIdx, string(token, length), lineNumber); // reports the error
+    return valueIdx;
+}
+
+// Converts a cost given directly in the read buffer, as WCSP::decimalToCost does
+// (parsed in place for plain integer or decimal numbers, copied into a string otherwise)
+Cost CFNStreamReader::getCost(const char* token, size_t length, int lineNumber)
+{
+    const char* end = token + length;
+    const char* c = token;
+    bool negative = false;
+    if (c != end && (*c == '-' || *c == '+')) {
+        negative = (*c == '-');
+        c++;
+    }
+    const char* digits = c;
+    Long integerPart = 0;
+    while (c != end && *c >= '0' && *c <= '9')
+        integerPart = 10 * integerPart + (*c++ - '0');
+    size_t nbDigits = c - digits;
+    if (nbDigits == 0 || nbDigits > 18)
+        return wcsp->decimalToCost(string(token, length), lineNumber);
+    if (c == end) {
+        return (Cost)(negative ? -integerPart : integerPart) * ToulBar2::costMultiplier * powl(10, ToulBar2::decimalPoint);
+    }
+    if (*c != '.')
+        return wcsp->decimalToCost(string(token, length), lineNumber);
+    c++;
+    const char* decimals = c;
+    Long decimalPart = 0;
+    while (c != end && *c >= '0' && *c <= '9')
+        decimalPart = 10 * decimalPart + (*c++ - '0');
+    size_t nbDecimals = c - decimals;
+    if (c != end || nbDecimals > 18)
+        return wcsp->decimalToCost(string(token, length), lineNumber);
+    int shift = ToulBar2::decimalPoint - nbDecimals;
+    Cost cost = (integerPart * powl(10, ToulBar2::decimalPoint) * ToulBar2::costMultiplier);
+    if (nbDecimals)
+        cost += decimalPart * powl(10, shift) * ToulBar2::costMultiplier;
+    if (negative)
+        cost = -cost;
+    return cost;
+}
+
 // Reads a scope.
 // Starts: after the opening brace of the scope.
 // Ends:   after the closing brace of the scope.
@@ -1179,15 +1374,17 @@ void CFNStreamReader::readNaryCostFunction(vector<int>& scope, bool all, Cost de
     }
 
     // Start reading
-    std::tie(lineNumber, token) = this->getNextToken();
+    const char* rawToken;
+    size_t length;
+    lineNumber = this->getNextToken(rawToken, length);
     if (not all) {
         unsigned int scopeIdx = 0; // Index of the cost table tuple
-        while (!isCBrace(token)) {
+        while (!(length == 1 && (*rawToken == '}' || *rawToken == ']'))) {
             // We have read a full tuple: finish the tuple
             if (scopeIdx == arity) {
                 buf[scopeIdx] = '\0';
                 tup = buf;
-                Cost cost = wcsp->decimalToCost(token, lineNumber);
+                Cost cost = getCost(rawToken, length, lineNumber);
                 if (CUT(cost, wcsp->getUb()) && (cost < MEDIUM_COST * wcsp->getUb()) && wcsp->getUb() < (MAX_COST / MEDIUM_COST))
                     cost *= MEDIUM_COST;
 
@@ -1202,13 +1399,13 @@ void CFNStreamReader::readNaryCostFunction(vector<int>& scope, bool all, Cost de
                     minCost = min(cost, minCost);
                 }
             } else {
-                unsigned int valueIdx = getValueIdx(scope[scopeIdx], token, lineNumber);
+                unsigned int valueIdx = getValueIdx(scope[scopeIdx], rawToken, length, lineNumber);
                 assert(valueIdx >= 0 && valueIdx < wcsp->getDomainInitSize(scope[scopeIdx]));
                 buf[scopeIdx] = valueIdx + CHAR_FIRST; // fill String
             }
 
             scopeIdx = ((scopeIdx == arity) ? 0 : scopeIdx + 1);
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(rawToken, length);
         }
         // Is there any remaining default cost (either too many tuples or less than we need)
         if ((logCard > log(std::numeric_limits<unsigned long>::max())) || nbTuples < card) {
@@ -1237,11 +1434,11 @@ void CFNStreamReader::readNaryCostFunction(vector<int>& scope, bool all, Cost de
         vector<Cost> costs;
 
         // Read all costs
-        while (!isCBrace(token)) {
-            costs.push_back(wcsp->decimalToCost(token, lineNumber));
+        while (!(length == 1 && (*rawToken == '}' || *rawToken == ']'))) {
+            costs.push_back(getCost(rawToken, length, lineNumber));
             minCost = min(minCost, cost);
             nbTuples++;
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(rawToken, length);
         }
 
         // Test if all tuples have been read
@@ -1963,65 +2160,18 @@ Cost WCSP::read_wcsp(const char* fileName)
     name = string(basename(Nfile2));
     free(Nfile2);
 
-    if (ToulBar2::cfn || (ToulBar2::stdin_format.compare("cfn") == 0)) {
+    if (ToulBar2::cfn || ToulBar2::cfngz || (ToulBar2::stdin_format.compare("cfn") == 0) || (ToulBar2::stdin_format.compare("cfn.gz") == 0)) {
 #ifdef BOOST
-        ifstream Rfile;
-        istream& stream = (ToulBar2::stdin_format.length() > 0) ? cin : Rfile;
-        if (ToulBar2::stdin_format.compare("cfn") == 0) {
-            CFNStreamReader fileReader(stream, this);
-            return getUb();
-
-        } else if (to_string(fileName).length() > 0) {
-            Rfile.open(fileName);
-            if (!stream) {
-                cerr << "Error: could not open file '" << fileName << "'." << endl;
-                exit(EXIT_FAILURE);
-
-            } else {
-                CFNStreamReader fileReader(stream, this);
-                return getUb();
-            }
+        CompressedInput input((ToulBar2::stdin_format.length() > 0) ? NULL : fileName);
+        if (!input.good()) {
+            cerr << "Error: could not open file '" << fileName << "'." << endl;
+            exit(EXIT_FAILURE);
         }
+        CFNStreamReader fileReader(input.stream(), this);
+        return getUb();
 #else
         cerr << "Error: compiling with Boost library is needed to allow to read CFN format files." << endl;
         exit(EXIT_FAILURE);
-#endif
-    } else if (ToulBar2::cfngz) {
-#ifdef BOOST
-        ifstream Rfile(fileName, std::ios_base::in | std::ios_base::binary);
-        istream& file = (ToulBar2::stdin_format.length() > 0) ? cin : Rfile;
-        boost::iostreams::filtering_streambuf<boost::iostreams::input> inbuf;
-        inbuf.push(boost::iostreams::gzip_decompressor());
-        inbuf.push(file);
-        std::istream stream(&inbuf);
-
-        if (ToulBar2::stdin_format.compare("cfn.gz") == 0) {
-            // read from instance from pipe  todo doesn work with pipe D. ALLouche
-            //            inbuf.push(file);
-            CFNStreamReader fileReader(stream, this);
-            return getUb();
-
-        } else if (to_string(fileName).length() > 0) {
-            // read instance from real file
-            //              inbuf.push(file);
-            //            std::istream stream(&inbuf);
-
-            // Rfile.open(fileName);
-            cout << "file: " << fileName << endl;
-            if (!file) {
-                cerr << "Could not open cfn.gz file : " << fileName << endl;
-                exit(EXIT_FAILURE);
-            } else {
-
-                //  inbuf.push(file);
-                CFNStreamReader fileReader(stream, this);
-                return getUb();
-            }
-        }
-
-#else
-        cerr << "Error: compiling with Boost iostreams library is needed to allow to read gzip'd CF format files." << endl;
-        exit(EXIT_FAILURE);
 #endif
     }
 
@@ -2061,6 +2211,9 @@ Cost WCSP::read_wcsp(const char* fileName)
     } else if (ToulBar2::qpbo) {
         read_qpbo(fileName);
         return getUb();
+    } else if (ToulBar2::wcspbin) {
+        read_wcspbin(fileName);
+        return getUb();
     }
     // TOOLBAR WCSP LEGACY PARSER
     string pbname;
@@ -2088,16 +2241,11 @@ Cost WCSP::read_wcsp(const char* fileName)
     vector<vector<String> > sharedTuples;
     vector<String> emptyTuples;
 
-    ifstream Rfile;
-    istream& file = (ToulBar2::stdin_format.length() > 0) ? cin : Rfile;
-    if (ToulBar2::stdin_format.compare("wcsp") == 0) {
-        //	   cout << "pipe reading: " << ToulBar2::stdin_format << endl;
-    } else if (to_string(fileName).length() > 0 and ToulBar2::stdin_format.length() == 0) {
-        Rfile.open(fileName);
-        if (!file) {
-            cerr << "Could not open wcsp file : " << fileName << endl;
-            exit(EXIT_FAILURE);
-        }
+    CompressedInput input((ToulBar2::stdin_format.length() > 0) ? NULL : fileName);
+    istream& file = input.stream();
+    if (!input.good()) {
+        cerr << "Could not open wcsp file : " << fileName << endl;
+        exit(EXIT_FAILURE);
     }
 
     // ---------- PROBLEM HEADER ----------
@@ -2601,6 +2749,171 @@ void WCSP::read_random(int n, int m, vector<int>& p, int seed, bool forceSubModu
     }
 }
 
+// Remaining text of an input stream, mapped in memory if it comes from a regular file (read into memory otherwise)
+class StreamText {
+    const char* data;
+    size_t size;
+    size_t offset; // position of the remaining text in data
+    bool mapped;
+    vector<char> copy;
+
+public:
+    StreamText(istream& stream, const char* fileName)
+        : data(NULL)
+        , size(0)
+        , offset(0)
+        , mapped(false)
+    {
+#ifdef LINUX
+        streampos current = ((fileName) ? stream.tellg() : streampos(-1));
+        if (current >= 0) {
+            int fd = open(fileName, O_RDONLY);
+            struct stat st;
+            if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= current) {
+                size = st.st_size;
+                offset = current;
+                void* mem = ((size > 0) ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED);
+                if (mem != MAP_FAILED) {
+                    data = (const char*)mem;
+                    mapped = true;
+                }
+            }
+            if (fd >= 0)
+                close(fd);
+        }
+#endif
+        if (!mapped) {
+            const size_t chunk = 1 << 20;
+            size_t nread = 0;
+            do {
+                copy.resize(nread + chunk);
+                stream.read(&copy[nread], chunk);
+                nread += stream.gcount();
+            } while (stream);
+            copy.resize(nread);
+            data = copy.data();
+            size = nread;
+            offset = 0;
+        }
+    }
+    ~StreamText()
+    {
+#ifdef LINUX
+        if (mapped)
+            munmap((void*)data, size);
+#endif
+    }
+
+    const char* begin() const { return data + offset; }
+    const char* end() const { return data + size; }
+};
+
+// Skips the next whitespace-separated token, returns false if there is no more token
+static bool skipToken(const char*& pos, const char* end)
+{
+    while (pos != end && isspace((unsigned char)*pos))
+        pos++;
+    if (pos == end)
+        return false;
+    while (pos != end && !isspace((unsigned char)*pos))
+        pos++;
+    return true;
+}
+
+static inline void convertNumber(const char* token, char** tokenEnd, int& value) { value = strtol(token, tokenEnd, 10); }
+static inline void convertNumber(const char* token, char** tokenEnd, double& value) { value = strtod(token, tokenEnd); }
+static inline void convertNumber(const char* token, char** tokenEnd, long double& value) { value = strtold(token, tokenEnd); }
+
+// Reads the next whitespace-separated token as a number, returns false if there is no more token or if it is not a number
+template <typename T>
+static bool readNumber(const char*& pos, const char* end, T& value)
+{
+    const char* start = pos;
+    if (!skipToken(pos, end))
+        return false;
+    while (isspace((unsigned char)*start))
+        start++;
+    size_t length = pos - start;
+    char buf[64];
+    if (length >= sizeof(buf))
+        return false;
+    memcpy(buf, start, length);
+    buf[length] = '\0';
+    char* tokenEnd;
+    convertNumber(buf, &tokenEnd, value);
+    return (tokenEnd == buf + length);
+}
+
+// Factor table of a uai file located by a first pass over the file
+struct UAIFactorTable {
+    size_t start; // position of the first probability
+    size_t end; // position after the last probability
+    int ntuples;
+    TProb maxp;
+    Cost minc;
+    Cost maxc; // maximum finite cost
+    bool zero; // all probabilities are zero in a .uai file (no solution)
+    bool error; // invalid probability
+
+    UAIFactorTable()
+        : start(0)
+        , end(0)
+        , ntuples(0)
+        , maxp(0.)
+        , minc(MAX_COST)
+        , maxc(MIN_COST)
+        , zero(false)
+        , error(false)
+    {
+    }
+};
+
+// Converts the probabilities of a factor table into costs (independently of the other tables)
+static void convertUAIFactorTable(const WCSP* wcsp, const char* text, UAIFactorTable& table, vector<Cost>& costs, bool markov)
+{
+    const char* pos = text + table.start;
+    const char* end = text + table.end;
+    vector<TProb> costsProb(table.ntuples);
+    TProb maxp = 0.;
+    for (int k = 0; k < table.ntuples; k++) {
+        TProb p;
+        if (!readNumber(pos, end, p)) {
+            table.error = true;
+            return;
+        }
+        assert(ToulBar2::uai > 1 || (p >= 0. && (markov || p <= 1.)));
+        costsProb[k] = p;
+        maxp = max(maxp, p);
+    }
+    table.maxp = maxp;
+    if (ToulBar2::uai == 1 && maxp == 0.) {
+        table.zero = true;
+        return;
+    }
+
+    costs.resize(table.ntuples);
+    for (int k = 0; k < table.ntuples; k++) {
+        TProb p = costsProb[k];
+        Cost cost;
+        // ToulBar2::uai is 1 for .uai and 2 for .LG (log domain)
+        if (markov)
+            cost = ((ToulBar2::uai > 1) ? wcsp->LogProb2Cost((TLogProb)(p - maxp)) : wcsp->Prob2Cost(p / maxp));
+        else
+            cost = ((ToulBar2::uai > 1) ? wcsp->LogProb2Cost((TLogProb)p) : wcsp->Prob2Cost(p));
+        costs[k] = cost;
+        if (cost < table.minc)
+            table.minc = cost;
+        if (cost > table.maxc && cost < wcsp->getUb())
+            table.maxc = cost;
+    }
+
+    if (ToulBar2::preprocessNary > 0 && table.minc > MIN_COST) {
+        for (int k = 0; k < table.ntuples; k++) {
+            costs[k] -= table.minc;
+        }
+    }
+}
+
 void WCSP::read_uai2008(const char* fileName)
 {
     // Compute the factor that enables to capture the difference in log for probability (1-10^resolution):
@@ -2614,16 +2927,11 @@ void WCSP::read_uai2008(const char* fileName)
 
     // Cost inclowerbound = MIN_COST;
     string uaitype;
-    ifstream Rfile;
-    istream& file = (ToulBar2::stdin_format.compare("uai") == 0) ? cin : Rfile;
-    if (ToulBar2::stdin_format.compare("uai") == 0) {
-        //		cout << "pipe reading: " << ToulBar2::stdin_format << endl;
-    } else {
-        Rfile.open(fileName);
-        if (!file) {
-            cerr << "Could not open file uai: " << fileName << endl;
-            exit(EXIT_FAILURE);
-        }
+    CompressedInput input((ToulBar2::stdin_format.compare("uai") == 0) ? NULL : fileName);
+    istream& file = input.stream();
+    if (!input.good()) {
+        cerr << "Could not open file uai: " << fileName << endl;
+        exit(EXIT_FAILURE);
     }
 
     Cost inclowerbound = MIN_COST;
@@ -2773,74 +3081,60 @@ void WCSP::read_uai2008(const char* fileName)
 
     ToulBar2::markov_log = 0; // for the MARKOV Case
 
-    int ntuplesarray[lctrs.size()];
-    vector<vector<Cost> > costs;
-    costs.resize(lctrs.size());
-    list<int>::iterator it = lctrs.begin();
-    while (it != lctrs.end()) {
-        file >> ntuples;
-        if (!file) {
+    // read factor tables in two passes: locate each table, then convert probabilities into costs in parallel
+    StreamText text(file, (input.isPlainFile()) ? fileName : NULL);
+    vector<UAIFactorTable> tables;
+    tables.reserve(lctrs.size());
+    const char* pos = text.begin();
+    while (tables.size() < lctrs.size()) {
+        UAIFactorTable table;
+        if (!readNumber(pos, text.end(), table.ntuples)) {
+            cerr << "Warning: EOF reached before reading all the factor tables (initial number of factors too large?)" << endl;
+            break;
+        }
+        table.start = pos - text.begin();
+        for (k = 0; k < table.ntuples && skipToken(pos, text.end()); k++) {
+        }
+        if (k < table.ntuples) {
             cerr << "Warning: EOF reached before reading all the factor tables (initial number of factors too large?)" << endl;
             break;
         }
-        ntuplesarray[ictr] = ntuples;
+        table.end = pos - text.begin();
+        tables.push_back(table);
+    }
+    if (skipToken(pos, text.end())) {
+        cerr << "Warning: EOF not reached after reading all the factor tables (initial number of factors too small?)" << endl;
+    }
 
-        TProb p;
-        vector<TProb> costsProb;
+    int ntuplesarray[lctrs.size()];
+    vector<vector<Cost> > costs;
+    costs.resize(lctrs.size());
+    for (ictr = 0; ictr < (int)lctrs.size(); ictr++)
+        ntuplesarray[ictr] = ((ictr < (int)tables.size()) ? tables[ictr].ntuples : 0);
 
-        TProb maxp = 0.;
-        for (k = 0; k < ntuples; k++) {
-            file >> p;
-            assert(ToulBar2::uai > 1 || (p >= 0. && (markov || p <= 1.)));
-            costsProb.push_back(p);
-            maxp = max(maxp, p);
-        }
-        if (ToulBar2::uai == 1 && maxp == 0.)
-            THROWCONTRADICTION;
+    parallelFor(tables.size(), getNbThreads(), [&](size_t t) { convertUAIFactorTable(this, text.begin(), tables[t], costs[t], markov); });
 
-        Cost minc = MAX_COST;
-        Cost maxc = MIN_COST;
-        for (k = 0; k < ntuples; k++) {
-            p = costsProb[k];
-            Cost cost;
-            // ToulBar2::uai is 1 for .uai and 2 for .LG (log domain)
-            if (markov)
-                cost = ((ToulBar2::uai > 1) ? LogProb2Cost((TLogProb)(p - maxp)) : Prob2Cost(p / maxp));
-            else
-                cost = ((ToulBar2::uai > 1) ? LogProb2Cost((TLogProb)p) : Prob2Cost(p));
-            costs[ictr].push_back(cost);
-            if (cost < minc)
-                minc = cost;
-            if (cost > maxc && cost < getUb())
-                maxc = cost;
+    for (ictr = 0; ictr < (int)tables.size(); ictr++) {
+        if (tables[ictr].error) {
+            cerr << "Error: invalid probability in factor table " << ictr << endl;
+            exit(EXIT_FAILURE);
         }
-        upperbound += maxc;
-
-        if (ToulBar2::preprocessNary > 0 && minc > MIN_COST) {
-            for (k = 0; k < ntuples; k++) {
-                costs[ictr][k] -= minc;
-            }
+        if (tables[ictr].zero)
+            THROWCONTRADICTION;
+        upperbound += tables[ictr].maxc;
+        if (ToulBar2::preprocessNary > 0 && tables[ictr].minc > MIN_COST) {
             if (ToulBar2::verbose >= 2)
-                cout << "IC0 performed for cost function " << ictr << " with initial minimum cost " << minc << endl;
-            inclowerbound += minc;
+                cout << "IC0 performed for cost function " << ictr << " with initial minimum cost " << tables[ictr].minc << endl;
+            inclowerbound += tables[ictr].minc;
         }
-
         if (markov)
-            ToulBar2::markov_log += ((ToulBar2::uai > 1) ? maxp : Log(maxp));
-
-        ictr++;
-        ++it;
-    }
-
-    file >> varname;
-    if (file) {
-        cerr << "Warning: EOF not reached after reading all the factor tables (initial number of factors too small?)" << endl;
+            ToulBar2::markov_log += ((ToulBar2::uai > 1) ? tables[ictr].maxp : Log(tables[ictr].maxp));
     }
 
     updateUb(upperbound);
 
     ictr = 0;
-    it = lctrs.begin();
+    list<int>::iterator it = lctrs.begin();
     while (it != lctrs.end()) {
         ntuples = ntuplesarray[ictr];
         for (k = 0; k < ntuples; k++) {
@@ -2933,7 +3227,7 @@ void WCSP::read_uai2008(const char* fileName)
     int nevi = 0;
     ifstream fevid(ToulBar2::evidence_file.c_str());
     if (!fevid) {
-        string strevid(string(fileName) + string(".evid"));
+        string strevid(uncompressedName(fileName) + string(".evid"));
         fevid.open(strevid.c_str());
         if (ToulBar2::verbose >= 0)
             cout << "No evidence file specified. Trying " << strevid << endl;
@@ -3061,18 +3355,72 @@ void WCSP::solution_XML(bool opt)
 #endif
 }
 
+// Skips blank characters and comment lines of a DIMACS file, returns false at the end of the text
+static bool skipDimacsComments(const char*& pos, const char* end)
+{
+    while (pos != end) {
+        if (isspace((unsigned char)*pos))
+            pos++;
+        else if (*pos == 'c') {
+            while (pos != end && *pos != '\n')
+                pos++;
+        } else
+            return true;
+    }
+    return false;
+}
+
+// Reads the next whitespace-separated token as an integer without copying it, returns false if it is not an integer
+static bool readDimacsInteger(const char*& pos, const char* end, Long& value)
+{
+    bool negative = (*pos == '-');
+    if (negative || *pos == '+')
+        pos++;
+    if (pos == end || !isdigit((unsigned char)*pos))
+        return false;
+    Long val = 0;
+    while (pos != end && isdigit((unsigned char)*pos)) {
+        val = 10 * val + (*pos - '0');
+        pos++;
+    }
+    if (pos != end && !isspace((unsigned char)*pos))
+        return false;
+    value = (negative) ? -val : val;
+    return true;
+}
+
+// Scope of binary or ternary clauses in increasing variable index order (third index is -1 for binary clauses)
+struct WCNFScope {
+    int vars[3];
+
+    bool operator==(const WCNFScope& s) const { return vars[0] == s.vars[0] && vars[1] == s.vars[1] && vars[2] == s.vars[2]; }
+};
+
+struct WCNFScopeHash {
+    size_t operator()(const WCNFScope& s) const
+    {
+        size_t h = s.vars[0];
+        h = h * 1000003 ^ (size_t)s.vars[1];
+        h = h * 1000003 ^ (size_t)s.vars[2];
+        return h;
+    }
+};
+
+// Binary or ternary clauses with the same scope merged into one cost table
+struct WCNFClauseTable {
+    int arity;
+    int scope[3]; // variables in the order of the first clause
+    size_t firstClause; // cost table is posted in place of its first clause
+    size_t costs; // position of its costs in a flat vector
+};
+
 void WCSP::read_wcnf(const char* fileName)
 {
-    ifstream Rfile;
-    istream& file = (ToulBar2::stdin_format.compare("wcnf") == 0 || ToulBar2::stdin_format.compare("cnf") == 0) ? cin : Rfile;
-    if (ToulBar2::stdin_format.compare("wcnf") == 0 || ToulBar2::stdin_format.compare("cnf") == 0) {
-        //                cout << "pipe reading: " << ToulBar2::stdin_format << endl;
-    } else {
-        Rfile.open(fileName);
-        if (!file) {
-            cerr << "Could not open file :: " << fileName << endl;
-            exit(EXIT_FAILURE);
-        }
+    CompressedInput input((ToulBar2::stdin_format.compare("wcnf") == 0 || ToulBar2::stdin_format.compare("cnf") == 0) ? NULL : fileName);
+    istream& file = input.stream();
+    if (!input.good()) {
+        cerr << "Could not open file :: " << fileName << endl;
+        exit(EXIT_FAILURE);
     }
 
     double K = ToulBar2::costMultiplier;
@@ -3131,100 +3479,146 @@ void WCSP::read_wcnf(const char* fileName)
         assert(theindex == i);
     }
 
-    // Read each clause
+    // Read all the clauses into a flat vector of literals (without repeated literals and tautologies)
+    StreamText text(file, (input.isPlainFile()) ? fileName : NULL);
+    const char* pos = text.begin();
+    const char* end = text.end();
+    vector<int> literals;
+    vector<size_t> clauseStart;
+    vector<Cost> clauseCost;
+    literals.reserve((end - pos) / 4);
+    clauseStart.reserve(nbclauses + 1);
+    clauseCost.reserve(nbclauses);
+    vector<int> lastClause(nbvar, -1); // last clause where a variable was found
+    vector<int> lastLiteral(nbvar, 0);
     for (int ic = 0; ic < nbclauses; ic++) {
-
-        int scopeIndex[MAX_ARITY];
-        Char buf[MAX_ARITY];
-        int arity = 0;
+        if (!skipDimacsComments(pos, end)) {
+            cerr << "Warning: EOF reached before reading all the clauses (initial number of clauses too large?)" << endl;
+            break;
+        }
         if (ToulBar2::verbose >= 3)
             cout << "read clause on ";
 
-        int j = 0;
-        Cost cost = UNIT_COST;
-        if (format == "wcnf")
-            file >> cost;
+        Long cost = UNIT_COST;
+        if (format == "wcnf" && !readDimacsInteger(pos, end, cost)) {
+            cerr << "Wrong clause weight in " << fileName << endl;
+            exit(EXIT_FAILURE);
+        }
+        size_t start = literals.size();
         bool tautology = false;
+        Long j = 0;
         do {
-            file >> j;
+            if (!skipDimacsComments(pos, end) || !readDimacsInteger(pos, end, j) || j < -nbvar || j > nbvar) {
+                cerr << "Wrong clause " << ic + 1 << " in " << fileName << endl;
+                exit(EXIT_FAILURE);
+            }
             if (j != 0 && !tautology) {
-                scopeIndex[arity] = abs(j) - 1;
-                buf[arity] = ((j > 0) ? 0 : 1) + CHAR_FIRST;
-                int k = 0;
-                while (k < arity) {
-                    if (scopeIndex[k] == scopeIndex[arity]) {
-                        break;
-                    }
-                    k++;
-                }
-                if (k < arity) {
-                    if (buf[k] != buf[arity]) {
+                int var = abs(j) - 1;
+                if (lastClause[var] == ic) {
+                    if (lastLiteral[var] != j) {
                         tautology = true;
                         if (ToulBar2::verbose >= 3)
                             cout << j << " is a tautology! skipped.";
                     }
                     continue;
                 }
-                arity++;
+                lastClause[var] = ic;
+                lastLiteral[var] = j;
+                literals.push_back(j);
                 if (ToulBar2::verbose >= 3)
                     cout << j << " ";
             }
         } while (j != 0);
         if (ToulBar2::verbose >= 3)
             cout << endl;
-        if (tautology)
+        if (tautology) {
+            literals.resize(start);
             continue;
-        buf[arity] = '\0';
-        maxarity = max(maxarity, arity);
+        }
+        clauseStart.push_back(start);
+        clauseCost.push_back(cost);
+        maxarity = max(maxarity, (int)(literals.size() - start));
+    }
+    size_t nbkept = clauseCost.size();
+    clauseStart.push_back(literals.size());
 
-        if (arity > 3) {
-            int index = postNaryConstraintBegin(scopeIndex, arity, MIN_COST, 1);
-            String tup = buf;
-            postNaryConstraintTuple(index, tup, cost * K);
-            postNaryConstraintEnd(index);
-        } else if (arity == 3) {
-            vector<Cost> costs;
-            for (int a = 0; a < 2; a++) {
-                for (int b = 0; b < 2; b++) {
-                    for (int c = 0; c < 2; c++) {
-                        costs.push_back(MIN_COST);
-                    }
-                }
-            }
-            costs[(buf[0] - CHAR_FIRST) * 4 + (buf[1] - CHAR_FIRST) * 2 + (buf[2] - CHAR_FIRST)] = cost * K;
-            postTernaryConstraint(scopeIndex[0], scopeIndex[1], scopeIndex[2], costs);
-        } else if (arity == 2) {
-            vector<Cost> costs;
-            for (int a = 0; a < 2; a++) {
-                for (int b = 0; b < 2; b++) {
-                    costs.push_back(MIN_COST);
-                }
-            }
-            costs[(buf[0] - CHAR_FIRST) * 2 + (buf[1] - CHAR_FIRST)] = cost * K;
-            postBinaryConstraint(scopeIndex[0], scopeIndex[1], costs);
+    if (skipDimacsComments(pos, end)) {
+        cerr << "Warning: EOF not reached after reading all the clauses (initial number of clauses too small?)" << endl;
+    }
+
+    // Merge unary clauses on the same variable and binary/ternary clauses on the same scope
+    vector<int> unaryIndex(nbvar, -1);
+    vector<WCNFClauseTable> tables;
+    vector<Cost> tableCosts;
+    vector<int> tableOf(nbkept, -1);
+    unordered_map<WCNFScope, int, WCNFScopeHash> tableIndex;
+    for (size_t c = 0; c < nbkept; c++) {
+        const int* clause = &literals[clauseStart[c]];
+        int arity = clauseStart[c + 1] - clauseStart[c];
+        Cost cost = clauseCost[c] * K;
+        if (arity == 0) {
+            inclowerbound += clauseCost[c] * K;
         } else if (arity == 1) {
-            EnumeratedVariable* x = (EnumeratedVariable*)vars[scopeIndex[0]];
-            TemporaryUnaryConstraint unaryconstr;
-            unaryconstr.var = x;
-            if ((buf[0] - CHAR_FIRST) == 0) {
-                unaryconstr.costs.push_back(cost * K);
-                unaryconstr.costs.push_back(MIN_COST);
-            } else {
-                unaryconstr.costs.push_back(MIN_COST);
-                unaryconstr.costs.push_back(cost * K);
+            int var = abs(clause[0]) - 1;
+            if (unaryIndex[var] < 0) {
+                unaryIndex[var] = unaryconstrs.size();
+                TemporaryUnaryConstraint unaryconstr;
+                unaryconstr.var = (EnumeratedVariable*)vars[var];
+                unaryconstr.costs.resize(2, MIN_COST);
+                unaryconstrs.push_back(unaryconstr);
+            }
+            unaryconstrs[unaryIndex[var]].costs[(clause[0] > 0) ? 0 : 1] += cost;
+        } else if (arity <= 3) {
+            WCNFScope key;
+            for (int k = 0; k < 3; k++)
+                key.vars[k] = ((k < arity) ? abs(clause[k]) - 1 : -1);
+            sort(key.vars, key.vars + arity);
+            auto found = tableIndex.insert(make_pair(key, (int)tables.size()));
+            if (found.second) {
+                WCNFClauseTable table;
+                table.arity = arity;
+                for (int k = 0; k < arity; k++)
+                    table.scope[k] = abs(clause[k]) - 1;
+                table.firstClause = c;
+                table.costs = tableCosts.size();
+                tables.push_back(table);
+                tableCosts.resize(tableCosts.size() + (1 << arity), MIN_COST);
+            }
+            const WCNFClauseTable& table = tables[found.first->second];
+            tableOf[c] = found.first->second;
+            // forbidden tuple of the clause in the order of the table scope
+            int tuple = 0;
+            for (int p = 0; p < arity; p++) {
+                int k = 0;
+                while (abs(clause[k]) - 1 != table.scope[p])
+                    k++;
+                tuple = 2 * tuple + ((clause[k] > 0) ? 0 : 1);
             }
-            unaryconstrs.push_back(unaryconstr);
-        } else if (arity == 0) {
-            inclowerbound += cost * K;
-        } else {
-            cerr << "Wrong clause arity " << arity << " in " << fileName << endl;
-            exit(EXIT_FAILURE);
+            tableCosts[table.costs + tuple] += cost;
         }
     }
 
-    file >> dummy;
-    if (file) {
-        cerr << "Warning: EOF not reached after reading all the clauses (initial number of clauses too small?)" << endl;
+    // Post clauses of arity greater than 3 and merged cost tables in the order of the file
+    vector<int> scopeIndex(maxarity);
+    String buf;
+    for (size_t c = 0; c < nbkept; c++) {
+        const int* clause = &literals[clauseStart[c]];
+        int arity = clauseStart[c + 1] - clauseStart[c];
+        if (arity > 3) {
+            buf.resize(arity);
+            for (int k = 0; k < arity; k++) {
+                scopeIndex[k] = abs(clause[k]) - 1;
+                buf[k] = ((clause[k] > 0) ? 0 : 1) + CHAR_FIRST;
+            }
+            postWeightedClause(scopeIndex.data(), arity, clauseCost[c] * K, buf);
+        } else if (arity >= 2 && tables[tableOf[c]].firstClause == c) {
+            const WCNFClauseTable& table = tables[tableOf[c]];
+            vector<Cost> costs(tableCosts.begin() + table.costs, tableCosts.begin() + table.costs + (1 << arity));
+            if (arity == 3)
+                postTernaryConstraint(table.scope[0], table.scope[1], table.scope[2], costs);
+            else
+                postBinaryConstraint(table.scope[0], table.scope[1], costs);
+        }
     }
 
     // apply basic initial propagation AFTER complete network loading
@@ -3247,16 +3641,11 @@ void WCSP::read_wcnf(const char* fileName)
 /// \warning It does not allow infinite costs (no forbidden assignments)
 void WCSP::read_qpbo(const char* fileName)
 {
-    ifstream Rfile;
-    istream& file = (ToulBar2::stdin_format.compare("qpbo") == 0) ? cin : Rfile;
-    if (ToulBar2::stdin_format.compare("qpbo") == 0) {
-        //		cout << "pipe reading: " << ToulBar2::stdin_format << endl;
-    } else {
-        Rfile.open(fileName);
-        if (!file) {
-            cerr << "Could not open file qpbo:: " << fileName << endl;
-            exit(EXIT_FAILURE);
-        }
+    CompressedInput input((ToulBar2::stdin_format.compare("qpbo") == 0) ? NULL : fileName);
+    istream& file = input.stream();
+    if (!input.good()) {
+        cerr << "Could not open file qpbo:: " << fileName << endl;
+        exit(EXIT_FAILURE);
     }
 
     int n = 0;
@@ -3272,31 +3661,33 @@ void WCSP::read_qpbo(const char* fileName)
     if (!minimize)
         m = -m;
     int e = 0;
-    int dummy;
 
+    // reads the nonzero matrix costs in memory (mapped directly if not compressed)
+    StreamText text(file, (input.isPlainFile()) ? fileName : NULL);
+    const char* pos = text.begin();
+    const char* end = text.end();
     vector<int> posx(m, 0);
     vector<int> posy(m, 0);
     vector<double> cost(m, 0.);
     for (e = 0; e < m; e++) {
-        file >> posx[e];
-
-        if (!file) {
+        if (!readNumber(pos, end, posx[e])) {
             cerr << "Warning: EOF reached before reading all the cost sparse matrix (number of nonzero costs too large?)" << endl;
             break;
         }
-        if (posx[e] > n) {
+        if (posx[e] > n || !readNumber(pos, end, posy[e]) || posy[e] > n) {
             cerr << "Warning: variable index too large!" << endl;
             break;
         }
-        file >> posy[e];
-        if (posy[e] > n) {
-            cerr << "Warning: variable index too large!" << endl;
+        if (posx[e] < 1 || posy[e] < 1) {
+            cerr << "Warning: variable index too small!" << endl;
+            break;
+        }
+        if (!readNumber(pos, end, cost[e])) {
+            cerr << "Warning: wrong nonzero cost!" << endl;
             break;
         }
-        file >> cost[e];
     }
-    file >> dummy;
-    if (file) {
+    if (skipToken(pos, end)) {
         cerr << "Warning: EOF not reached after reading all the cost sparse matrix (wrong number of nonzero costs too small?)" << endl;
     }
     m = e;
@@ -3307,9 +3698,6 @@ void WCSP::read_qpbo(const char* fileName)
         makeEnumeratedVariable(to_string(i), 0, 1);
     }
 
-    vector<Cost> unaryCosts0(n, 0);
-    vector<Cost> unaryCosts1(n, 0);
-
     // find total cost
     Double sumcost = 0.;
     for (int e = 0; e < m; e++) {
@@ -3322,90 +3710,8 @@ void WCSP::read_qpbo(const char* fileName)
     }
     updateUb((Cost)multiplier * sumcost + 1);
 
-    // create weighted binary clauses
-    for (int e = 0; e < m; e++) {
-        if (posx[e] != posy[e]) {
-            vector<Cost> costs(4, 0);
-            if (booldom) {
-                if (cost[e] > 0) {
-                    if (minimize) {
-                        costs[3] = (Cost)(multiplier * 2. * cost[e]);
-                    } else {
-                        costs[0] = (Cost)(multiplier * 2. * cost[e]);
-                        costs[1] = costs[0];
-                        costs[2] = costs[0];
-                    }
-                } else {
-                    if (minimize) {
-                        costs[0] = (Cost)(multiplier * -2. * cost[e]);
-                        costs[1] = costs[0];
-                        costs[2] = costs[0];
-                    } else {
-                        costs[3] = (Cost)(multiplier * -2. * cost[e]);
-                    }
-                }
-            } else {
-                if (cost[e] > 0) {
-                    if (minimize) {
-                        costs[0] = (Cost)(multiplier * 2. * cost[e]);
-                        costs[3] = costs[0];
-                    } else {
-                        costs[1] = (Cost)(multiplier * 2. * cost[e]);
-                        costs[2] = costs[1];
-                    }
-                } else {
-                    if (minimize) {
-                        costs[1] = (Cost)(multiplier * -2. * cost[e]);
-                        costs[2] = costs[1];
-                    } else {
-                        costs[0] = (Cost)(multiplier * -2. * cost[e]);
-                        costs[3] = costs[0];
-                    }
-                }
-            }
-            postBinaryConstraint(posx[e] - 1, posy[e] - 1, costs);
-        } else {
-            if (booldom) {
-                if (cost[e] > 0) {
-                    if (minimize) {
-                        unaryCosts1[posx[e] - 1] += (Cost)(multiplier * cost[e]);
-                    } else {
-                        unaryCosts0[posx[e] - 1] += (Cost)(multiplier * cost[e]);
-                    }
-                } else {
-                    if (minimize) {
-                        unaryCosts0[posx[e] - 1] += (Cost)(multiplier * -cost[e]);
-                    } else {
-                        unaryCosts1[posx[e] - 1] += (Cost)(multiplier * -cost[e]);
-                    }
-                }
-            } else {
-                if (cost[e] > 0) {
-                    if (minimize) {
-                        unaryCosts0[posx[e] - 1] += (Cost)(multiplier * cost[e]);
-                    } else {
-                        unaryCosts1[posx[e] - 1] += (Cost)(multiplier * cost[e]);
-                    }
-                } else {
-                    if (minimize) {
-                        unaryCosts1[posx[e] - 1] += (Cost)(multiplier * -cost[e]);
-                    } else {
-                        unaryCosts0[posx[e] - 1] += (Cost)(multiplier * -cost[e]);
-                    }
-                }
-            }
-        }
-    }
-
-    // create weighted unary clauses
-    for (int i = 0; i < n; i++) {
-        if (unaryCosts0[i] > 0 || unaryCosts1[i] > 0) {
-            vector<Cost> costs(2, 0);
-            costs[0] = unaryCosts0[i];
-            costs[1] = unaryCosts1[i];
-            postUnaryConstraint(i, costs);
-        }
-    }
+    // create weighted binary and unary clauses
+    postQuadraticBooleanFunction(n, m, posx.data(), posy.data(), cost.data(), multiplier, booldom, minimize);
     sortConstraints();
     if (ToulBar2::verbose >= 0)
         cout << "Read " << n << " variables, with " << 2 << " values at most, and " << m << " nonzero matrix costs." << endl;
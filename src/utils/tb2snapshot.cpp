@@ -0,0 +1,502 @@
+/*
+ * **************** Read and write binary snapshots of cost function networks **************************
+ *
+ */
+
+#include "core/tb2wcsp.hpp"
+#include "core/tb2enumvar.hpp"
+#include "core/tb2binconstr.hpp"
+#include "core/tb2ternaryconstr.hpp"
+#include "core/tb2naryconstr.hpp"
+
+#ifdef LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * \defgroup wcspbinformat Binary snapshot file format (wcspbin)
+ *
+ * A binary snapshot is a raw image of a cost function network after reading (option -z=problem.wcspbin)
+ * or after preprocessing (options -z=problem.wcspbin -z=2), which is loaded by mapping the file in memory without any parsing.
+ * It uses the native byte order and the sizes of ::Cost and ::Long of the toulbar2 executable which created it.
+ * Each section starts on an 8-byte boundary:
+ * - a header (SnapshotHeader) giving the number of variables and cost functions, the initial upper bound, the constant lower bound, and the cost precision (see -C and -precision options)
+ * - for each variable, its domain size and its number of value names (SnapshotVariable)
+ * - all the unary costs (a flat array of domain size costs per variable)
+ * - the names of all the variables, each one followed by the names of its values, as null-terminated strings
+ * - for each cost function, its arity, number of tuples, and default cost (SnapshotFunction),
+ *   followed by its scope (variable indexes), its costs, and its tuples if not given as a full table (arity value indexes per tuple, stored as unsigned int)
+ *
+ * Domain values are always indexes from 0 to domain size minus one. Binary and ternary cost functions are stored as full tables
+ * (last variable in the scope varying the fastest), other cost functions as a list of tuples with a default cost.
+ * When saving after preprocessing, assigned variables are removed and the remaining domains are renumbered (as in the wcsp format).
+ *
+ * \note Cost tables are copied once from the mapped file as they are modified during search.
+ * \warning Interval variables are not supported. Cost functions which are not given in extension (\e e.g. global cost functions) are enumerated if their Cartesian product is small enough.
+ */
+
+static const char SNAPSHOT_MAGIC[8] = "TB2SNAP";
+static const int SNAPSHOT_VERSION = 1;
+static const Long SNAPSHOT_MAX_ENUMERATION = (1 << 24); // maximum number of tuples of a cost function in intention to be enumerated
+
+struct SnapshotHeader {
+    char magic[8];
+    int version;
+    int costSize;
+    Long nbVars;
+    Long nbFunctions;
+    Long namesSize;
+    Cost ub;
+    Cost lb;
+    Cost negCost;
+    double costMultiplier;
+    Long decimalPoint;
+};
+
+struct SnapshotVariable {
+    Long domainSize;
+    Long nbValueNames;
+};
+
+struct SnapshotFunction {
+    Long arity;
+    Long nbTuples; // negative if costs are given as a full table
+    Cost defCost;
+};
+
+class SnapshotWriter {
+    ofstream& os;
+
+public:
+    SnapshotWriter(ofstream& os_in)
+        : os(os_in)
+    {
+    }
+
+    void write(const void* data, size_t size) { os.write((const char*)data, size); }
+    template <class T>
+    void write(const T& x) { write(&x, sizeof(T)); }
+    template <class T>
+    void write(const vector<T>& v)
+    {
+        if (!v.empty())
+            write(&v[0], v.size() * sizeof(T));
+    }
+    void align()
+    {
+        static const char zeros[8] = { 0 };
+        size_t rest = (size_t)os.tellp() % 8;
+        if (rest)
+            write(zeros, 8 - rest);
+    }
+};
+
+class SnapshotReader {
+    const char* start;
+    const char* current;
+    const char* end;
+
+public:
+    SnapshotReader(const char* data, size_t size)
+        : start(data)
+        , current(data)
+        , end(data + size)
+    {
+    }
+
+    template <class T>
+    const T* take(size_t nb)
+    {
+        if (nb > (size_t)(end - current) / sizeof(T)) {
+            cerr << "Error: truncated binary snapshot file!" << endl;
+            exit(EXIT_FAILURE);
+        }
+        const T* res = (const T*)current;
+        current += nb * sizeof(T);
+        return res;
+    }
+    void align()
+    {
+        size_t rest = (current - start) % 8;
+        if (rest)
+            current += min((size_t)(8 - rest), (size_t)(end - current));
+    }
+};
+
+void WCSP::dump_wcspbin(const char* fileName, bool original)
+{
+    vector<Constraint*> functions;
+    for (unsigned int i = 0; i < constrs.size(); i++)
+        if (constrs[i]->connected() && !constrs[i]->isSep())
+            functions.push_back(constrs[i]);
+    for (int i = 0; i < elimBinOrder; i++)
+        if (elimBinConstrs[i]->connected() && !elimBinConstrs[i]->isSep())
+            functions.push_back(elimBinConstrs[i]);
+    for (int i = 0; i < elimTernOrder; i++)
+        if (elimTernConstrs[i]->connected() && !elimTernConstrs[i]->isSep())
+            functions.push_back(elimTernConstrs[i]);
+    for (vector<Constraint*>::iterator it = functions.begin(); it != functions.end(); ++it) {
+        if (!(*it)->extension() && (*it)->getDomainSizeProduct() > SNAPSHOT_MAX_ENUMERATION) {
+            cerr << "Error: cannot save a cost function of arity " << (*it)->arity() << " in a binary snapshot (too many tuples to enumerate)! Use wcsp format instead." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (unsigned int i = 0; i < vars.size(); i++) {
+        if (!vars[i]->enumerated()) {
+            cerr << "Error: cannot save interval variable " << vars[i]->getName() << " in a binary snapshot!" << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    ofstream file(fileName, std::ios_base::out | std::ios_base::binary);
+    if (!file) {
+        cerr << "Error: cannot write binary snapshot file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+    SnapshotWriter out(file);
+    Cost ub = getUb();
+    Cost lb = getLb();
+
+    // saved variables and their domains (position in the domain vector gives the saved value index)
+    vector<int> index(vars.size(), -1);
+    vector<EnumeratedVariable*> saved;
+    vector<vector<Value> > domains;
+    for (unsigned int i = 0; i < vars.size(); i++) {
+        EnumeratedVariable* x = (EnumeratedVariable*)vars[i];
+        if (original || x->unassigned()) {
+            index[i] = saved.size();
+            saved.push_back(x);
+            domains.push_back(vector<Value>());
+            if (original) {
+                for (unsigned int a = 0; a < x->getDomainInitSize(); a++)
+                    domains.back().push_back(x->toValue(a));
+            } else {
+                for (EnumeratedVariable::iterator iter = x->begin(); iter != x->end(); ++iter)
+                    domains.back().push_back(*iter);
+            }
+        }
+    }
+    // value index in the snapshot of a value in the current domain
+    auto position = [original](EnumeratedVariable* x, Value v) { return (unsigned int)((original) ? x->toIndex(v) : x->toCurrentIndex(v)); };
+    auto saturate = [original, ub](Cost c) { return (original) ? c : min(ub, c); };
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    out.write(header); // rewritten at the end
+
+    string names;
+    for (unsigned int i = 0; i < saved.size(); i++) {
+        SnapshotVariable var;
+        var.domainSize = domains[i].size();
+        var.nbValueNames = ((saved[i]->hasValueNames()) ? domains[i].size() : 0);
+        out.write(var);
+        names += saved[i]->getName();
+        names += '\0';
+        for (Long a = 0; a < var.nbValueNames; a++) {
+            names += saved[i]->getValueName(saved[i]->toIndex(domains[i][a]));
+            names += '\0';
+        }
+    }
+    for (unsigned int i = 0; i < saved.size(); i++) {
+        vector<Cost> costs(domains[i].size(), ub);
+        for (EnumeratedVariable::iterator iter = saved[i]->begin(); iter != saved[i]->end(); ++iter) {
+            costs[position(saved[i], *iter)] = saturate(saved[i]->getCost(*iter));
+        }
+        out.write(costs);
+    }
+    out.write(names.data(), names.size());
+    out.align();
+
+    Long nbFunctions = 0;
+    for (vector<Constraint*>::iterator it = functions.begin(); it != functions.end(); ++it) {
+        Constraint* ctr = *it;
+        int arity = ctr->arity();
+        vector<Long> scope;
+        vector<int> kept; // positions in the scope of the saved variables
+        for (int i = 0; i < arity; i++) {
+            if (index[ctr->getVar(i)->wcspIndex] >= 0) {
+                scope.push_back(index[ctr->getVar(i)->wcspIndex]);
+                kept.push_back(i);
+            }
+        }
+        SnapshotFunction function;
+        function.arity = scope.size();
+        function.defCost = MIN_COST;
+        vector<Cost> costs;
+        vector<unsigned int> tuples;
+        if (ctr->isBinary()) {
+            assert(function.arity == 2);
+            BinaryConstraint* bctr = (BinaryConstraint*)ctr;
+            EnumeratedVariable* x = (EnumeratedVariable*)bctr->getVar(0);
+            EnumeratedVariable* y = (EnumeratedVariable*)bctr->getVar(1);
+            size_t sizey = domains[scope[1]].size();
+            costs.assign(domains[scope[0]].size() * sizey, MIN_COST);
+            for (EnumeratedVariable::iterator iterX = x->begin(); iterX != x->end(); ++iterX) {
+                for (EnumeratedVariable::iterator iterY = y->begin(); iterY != y->end(); ++iterY) {
+                    costs[position(x, *iterX) * sizey + position(y, *iterY)] = saturate(bctr->getCost(*iterX, *iterY));
+                }
+            }
+            function.nbTuples = -1;
+        } else if (ctr->isTernary()) {
+            assert(function.arity == 3);
+            TernaryConstraint* tctr = (TernaryConstraint*)ctr;
+            EnumeratedVariable* x = (EnumeratedVariable*)tctr->getVar(0);
+            EnumeratedVariable* y = (EnumeratedVariable*)tctr->getVar(1);
+            EnumeratedVariable* z = (EnumeratedVariable*)tctr->getVar(2);
+            size_t sizey = domains[scope[1]].size();
+            size_t sizez = domains[scope[2]].size();
+            costs.assign(domains[scope[0]].size() * sizey * sizez, MIN_COST);
+            for (EnumeratedVariable::iterator iterX = x->begin(); iterX != x->end(); ++iterX) {
+                for (EnumeratedVariable::iterator iterY = y->begin(); iterY != y->end(); ++iterY) {
+                    for (EnumeratedVariable::iterator iterZ = z->begin(); iterZ != z->end(); ++iterZ) {
+                        costs[(position(x, *iterX) * sizey + position(y, *iterY)) * sizez + position(z, *iterZ)] = saturate(tctr->getCost(*iterX, *iterY, *iterZ));
+                    }
+                }
+            }
+            function.nbTuples = -1;
+        } else {
+            String t;
+            Cost c;
+            if (ctr->isNary()) {
+                function.defCost = saturate(((NaryConstraint*)ctr)->getDefCost());
+                ctr->first();
+            } else {
+                ctr->firstlex();
+            }
+            while ((ctr->isNary()) ? ctr->next(t, c) : ctr->nextlex(t, c)) {
+                if (c == function.defCost)
+                    continue;
+                for (vector<int>::iterator i = kept.begin(); i != kept.end(); ++i) {
+                    EnumeratedVariable* x = (EnumeratedVariable*)ctr->getVar(*i);
+                    tuples.push_back(position(x, x->toValue(t[*i] - CHAR_FIRST)));
+                }
+                costs.push_back(saturate(c));
+            }
+            function.nbTuples = costs.size();
+        }
+        if (function.arity == 0) { // all variables are assigned
+            assert(costs.size() <= 1);
+            lb += ((costs.size() > 0) ? costs[0] : function.defCost);
+            continue;
+        }
+        out.write(function);
+        out.write(scope);
+        out.write(costs);
+        out.write(tuples);
+        out.align();
+        nbFunctions++;
+    }
+
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.costSize = sizeof(Cost);
+    header.nbVars = saved.size();
+    header.nbFunctions = nbFunctions;
+    header.namesSize = names.size();
+    header.ub = ub;
+    header.lb = lb;
+    header.negCost = negCost;
+    header.costMultiplier = ToulBar2::costMultiplier;
+    header.decimalPoint = ToulBar2::decimalPoint;
+    file.seekp(0);
+    out.write(header);
+    file.close();
+    if (!file) {
+        cerr << "Error: cannot write binary snapshot file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (ToulBar2::verbose >= 0)
+        cout << "Binary snapshot saved in " << fileName << " (" << saved.size() << " variables and " << nbFunctions << " cost functions)." << endl;
+}
+
+void WCSP::read_wcspbin(const char* fileName)
+{
+    size_t size = 0;
+    char* data = NULL;
+#ifdef LINUX
+    int fd = open(fileName, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        cerr << "Error: could not open binary snapshot file '" << fileName << "'." << endl;
+        exit(EXIT_FAILURE);
+    }
+    size = st.st_size;
+    if (size > 0) {
+        data = (char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0); // costs are read without parsing nor copying the file
+        if (data == MAP_FAILED) {
+            cerr << "Error: cannot map binary snapshot file '" << fileName << "' in memory." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    close(fd);
+#else
+    ifstream file(fileName, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+    if (!file) {
+        cerr << "Error: could not open binary snapshot file '" << fileName << "'." << endl;
+        exit(EXIT_FAILURE);
+    }
+    size = file.tellg();
+    data = new char[size];
+    file.seekg(0);
+    file.read(data, size);
+#endif
+    SnapshotReader in(data, size);
+
+    const SnapshotHeader* header = in.take<SnapshotHeader>(1);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 || header->version != SNAPSHOT_VERSION) {
+        cerr << "Error: " << fileName << " is not a binary snapshot file of this version of toulbar2!" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (header->costSize != sizeof(Cost)) {
+        cerr << "Error: binary snapshot file " << fileName << " was saved with another type of costs (see LONGLONG_COST compilation flag)!" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (ToulBar2::costMultiplier != UNIT_COST) {
+        cerr << "Error: cost multiplier cannot be used with binary snapshots (costs are already multiplied)." << endl;
+        exit(EXIT_FAILURE);
+    }
+    ToulBar2::costMultiplier = header->costMultiplier;
+    ToulBar2::decimalPoint = header->decimalPoint;
+    negCost = header->negCost;
+    updateUb(header->ub);
+
+    assert(vars.empty());
+    assert(constrs.empty());
+    int nbvar = header->nbVars;
+    ToulBar2::nbvar = nbvar;
+    const SnapshotVariable* variables = in.take<SnapshotVariable>(nbvar);
+    vector<const Cost*> unaryCosts(nbvar, NULL);
+    Long maxdomsize = 0;
+    for (int i = 0; i < nbvar; i++) {
+        unaryCosts[i] = in.take<Cost>(variables[i].domainSize);
+        maxdomsize = max(maxdomsize, variables[i].domainSize);
+    }
+    const char* names = in.take<char>(header->namesSize);
+    const char* namesEnd = names + header->namesSize;
+    in.align();
+    for (int i = 0; i < nbvar; i++) {
+        string varname(names, strnlen(names, namesEnd - names));
+        names += varname.size() + 1;
+        DEBONLY(int theindex =)
+        makeEnumeratedVariable(varname, 0, variables[i].domainSize - 1);
+        assert(theindex == i);
+        for (Long a = 0; a < variables[i].nbValueNames; a++) {
+            string valuename(names, strnlen(names, namesEnd - names));
+            names += valuename.size() + 1;
+            vars[i]->newValueName(valuename);
+        }
+    }
+    if (names > namesEnd) {
+        cerr << "Error: truncated binary snapshot file!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // merge unary cost functions given as tuples with the unary costs of each variable
+    vector<vector<Cost> > unaries(nbvar);
+    for (int i = 0; i < nbvar; i++)
+        unaries[i].assign(unaryCosts[i], unaryCosts[i] + variables[i].domainSize);
+
+    int maxarity = 0;
+    for (Long f = 0; f < header->nbFunctions; f++) {
+        const SnapshotFunction* function = in.take<SnapshotFunction>(1);
+        int arity = function->arity;
+        const Long* scope = in.take<Long>(arity);
+        int scopeIndex[arity];
+        size_t tablesize = 1;
+        for (int i = 0; i < arity; i++) {
+            if (scope[i] < 0 || scope[i] >= nbvar) {
+                cerr << "Error: wrong variable index in binary snapshot file!" << endl;
+                exit(EXIT_FAILURE);
+            }
+            scopeIndex[i] = scope[i];
+            tablesize *= variables[scope[i]].domainSize;
+        }
+        maxarity = max(maxarity, arity);
+        if (function->nbTuples < 0) {
+            const Cost* table = in.take<Cost>(tablesize);
+            vector<Cost> costs(table, table + tablesize);
+            if (arity == 2) {
+                postBinaryConstraint(scopeIndex[0], scopeIndex[1], costs);
+            } else if (arity == 3) {
+                postTernaryConstraint(scopeIndex[0], scopeIndex[1], scopeIndex[2], costs);
+            } else {
+                cerr << "Error: wrong arity " << arity << " for a cost table in binary snapshot file!" << endl;
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            Long ntuples = function->nbTuples;
+            const Cost* costs = in.take<Cost>(ntuples);
+            const unsigned int* tuples = in.take<unsigned int>(ntuples * arity);
+            for (Long t = 0; t < ntuples * arity; t++) {
+                if (tuples[t] >= variables[scope[t % arity]].domainSize) {
+                    cerr << "Error: wrong value index in binary snapshot file!" << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            if (arity <= 3) {
+                vector<Cost> table(tablesize, function->defCost);
+                for (Long t = 0; t < ntuples; t++) {
+                    size_t idx = 0;
+                    for (int i = 0; i < arity; i++)
+                        idx = idx * variables[scope[i]].domainSize + tuples[t * arity + i];
+                    table[idx] = costs[t];
+                }
+                if (arity == 1) {
+                    for (size_t a = 0; a < tablesize; a++) {
+                        if (unaries[scopeIndex[0]][a] < getUb()) {
+                            if (table[a] < getUb())
+                                unaries[scopeIndex[0]][a] += table[a];
+                            else
+                                unaries[scopeIndex[0]][a] = getUb();
+                        }
+                    }
+                } else if (arity == 2) {
+                    postBinaryConstraint(scopeIndex[0], scopeIndex[1], table);
+                } else {
+                    postTernaryConstraint(scopeIndex[0], scopeIndex[1], scopeIndex[2], table);
+                }
+            } else if (function->defCost != MIN_COST || ntuples > 0) {
+                if (arity > MAX_ARITY) {
+                    cerr << "Nary cost functions of arity > " << MAX_ARITY << " not supported" << endl;
+                    exit(EXIT_FAILURE);
+                }
+                int naryIndex = postNaryConstraintBegin(scopeIndex, arity, function->defCost, ntuples);
+                String tuple(arity, CHAR_FIRST);
+                for (Long t = 0; t < ntuples; t++) {
+                    for (int i = 0; i < arity; i++)
+                        tuple[i] = tuples[t * arity + i] + CHAR_FIRST;
+                    postNaryConstraintTuple(naryIndex, tuple, costs[t]);
+                }
+                postNaryConstraintEnd(naryIndex);
+            }
+        }
+        in.align();
+    }
+
+    // apply basic initial propagation AFTER complete network loading (same order as in wcsp format)
+    increaseLb(header->lb);
+    for (int i = 0; i < nbvar; i++) {
+        postUnaryConstraint(i, unaries[i]);
+    }
+    sortConstraints();
+
+    Long nbFunctions = header->nbFunctions;
+#ifdef LINUX
+    if (data)
+        munmap(data, size);
+#else
+    delete[] data;
+#endif
+    if (ToulBar2::verbose >= 0)
+        cout << "Read " << nbvar << " variables, with " << maxdomsize << " values at most, and " << nbFunctions << " cost functions, with maximum arity " << maxarity << "." << endl;
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
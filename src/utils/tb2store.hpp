@@ -4,21 +4,25 @@
  *	\defgroup backtrack Backtrack management
  *  Used by backtrack search methods.
  *  Allows to copy / restore the current state using Store::store and Store::restore methods.
- *  All storable data modifications are trailed into specific stacks.
+ *  All storable data modifications are trailed into a single stack, Store::trail, made of tagged entries:
+ *  - storable domain values ::StoreValue (value supports, etc)
+ *  - storable costs ::StoreCost (inside cost functions, etc)
+ *  - backtrackable lists of values (enumerated domains to manage holes inside domains, unassigned variables, etc)
+ *  - words of bitset domains (enumerated domains when compiled with BITSETDOMAIN, see Domain)
+ *  - backtrackable lists of constraints, variables and separators (see tree decomposition methods)
  *
- *  Trailing stacks are associated to each storable type:
- *  - Store::storeValue for storable domain values ::StoreValue (value supports, etc)
- *  - Store::storeCost for storable costs ::StoreCost (inside cost functions, etc)
- *  - Store::storeDomain for enumerated domains (to manage holes inside domains)
- *  - Store::storeConstraint for backtrackable lists of constraints
- *  - Store::storeVariable for backtrackable lists of variables
- *  - Store::storeSeparator for backtrackable lists of separators (see tree decomposition methods)
- *  - Store::storeBigInteger for very large integers ::StoreBigInteger used in solution counting methods
+ *  Very large integers ::StoreBigInteger used in solution counting methods are trailed into their own stack (StoreBasic<BigInteger>::mystore).
  *
- *  Memory for each stack is dynamically allocated by part of \f$2^x\f$ with \e x initialized to ::STORE_SIZE and increased when needed.
+ *  Cost tables of cost functions (see StoreCostTable) can instead be checkpointed by copy-on-write pages (see ToulBar2::costCheckpoint):
+ *  the first modification of a page at a given depth copies the whole page and trails a single entry.
+ *  Sparse cost tables only store the costs different from a default cost, each one being trailed in place.
+ *
+ *  Memory for each stack is dynamically allocated by part of \f$2^x\f$ with \e x initialized to ::STORE_SIZE and increased when needed
+ *  (the unified trail is grown in place by mremap under Linux).
  *  \note storable data are not trailed at depth 0.
- *  \warning ::StoreInt uses Store::storeValue stack (it assumes Value is encoded as int!).
+ *  \warning ::StoreInt uses the same trail entries as ::StoreValue (it assumes Value is encoded as int!).
  *  \warning Current storable data management is not multi-threading safe! (Store is a static virtual class relying on StoreBasic<T> static members)
+ *  Parallel search uses processes instead, each one owning its own stacks (see Portfolio).
  */
 
 #ifndef TB2STORE_HPP_
@@ -39,8 +43,14 @@
 #endif
 #endif
 
+#ifdef LINUX
+#include <sys/mman.h>
+#endif
+#include <unordered_map>
+
 template <class T>
 class BTList;
+class StoreCostTable;
 template <class T>
 class DLink;
 class Constraint;
@@ -183,9 +193,6 @@ public:
     {
         *adr[x] = val[x];
     }
-    template <class Q>
-    void restore(BTList<Q>** l, DLink<Q>** elt, ptrdiff_t& x);
-
     void restore()
     {
         if (index > 0) { // do nothing if already at depth = 0
@@ -203,6 +210,247 @@ public:
     }
 };
 
+typedef unsigned long long BitWord; // word of a bitset domain (see Domain)
+
+/*
+ * Unified trail of storable values, costs and backtrackable lists
+ *
+ */
+class StoreTrail {
+public:
+    enum Tag : unsigned char {
+        TRAIL_LEVEL, // beginning of a new depth (content is the position of the previous one)
+        TRAIL_VALUE,
+        TRAIL_COST,
+        TRAIL_DOMAIN, // BTList<Value>
+        TRAIL_CONSTRAINT, // BTList<ConstraintLink>
+        TRAIL_VARIABLE, // BTList<Variable*>
+        TRAIL_SEPARATOR, // BTList<Separator*>
+        TRAIL_PAGE, // copied page of a StoreCostTable
+        TRAIL_BITS // word of a bitset domain
+    };
+
+private:
+    // structure of arrays, one entry per trailed modification
+    unsigned char* tags;
+    void** addresses;
+    Long* contents; // previous value or cost, list element, or position of the previous level
+    ptrdiff_t index;
+    ptrdiff_t indexMax;
+    ptrdiff_t base;
+
+    // make it private because we don't want copy nor assignment
+    StoreTrail(const StoreTrail& s);
+    StoreTrail& operator=(const StoreTrail& s);
+
+    template <class A>
+    static A* allocate(ptrdiff_t size)
+    {
+#ifdef LINUX
+        void* mem = mmap(NULL, size * sizeof(A), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return (mem == MAP_FAILED) ? NULL : (A*)mem;
+#else
+        return new A[size];
+#endif
+    }
+
+    template <class A>
+    static A* reallocate(A* array, ptrdiff_t oldSize, ptrdiff_t newSize)
+    {
+#ifdef LINUX
+        void* mem = mremap(array, oldSize * sizeof(A), newSize * sizeof(A), MREMAP_MAYMOVE); // no copy, pages are remapped
+        return (mem == MAP_FAILED) ? NULL : (A*)mem;
+#else
+        A* newarray = new A[newSize];
+        std::copy(array, array + oldSize, newarray);
+        delete[] array;
+        return newarray;
+#endif
+    }
+
+    template <class A>
+    static void deallocate(A* array, ptrdiff_t size)
+    {
+#ifdef LINUX
+        munmap(array, size * sizeof(A));
+#else
+        delete[] array;
+#endif
+    }
+
+    void realloc()
+    {
+        tags = reallocate(tags, indexMax, indexMax * 2);
+        addresses = reallocate(addresses, indexMax, indexMax * 2);
+        contents = reallocate(contents, indexMax, indexMax * 2);
+        if (!tags || !addresses || !contents) {
+            cerr << "trail stack out of memory!" << endl;
+            exit(EXIT_FAILURE);
+        }
+        indexMax *= 2;
+        if (ToulBar2::verbose >= 0) {
+            cout << "c " << indexMax * (sizeof(unsigned char) + sizeof(void*) + sizeof(Long)) << " Bytes allocated for trail stack." << endl;
+        }
+    }
+
+    void push(Tag tag, void* x, Long y)
+    {
+        index++;
+        if (index >= indexMax)
+            realloc();
+        tags[index] = tag;
+        addresses[index] = x;
+        contents[index] = y;
+    }
+
+    template <class Q>
+    void restoreList(ptrdiff_t& x); // defined in tb2btlist.hpp
+    void restorePage(ptrdiff_t x);
+
+public:
+    StoreTrail(int powbckmemory = STORE_SIZE)
+    {
+        if (pow(2., powbckmemory) >= SIZE_MAX) {
+            cerr << "command-line initial memory size parameter " << powbckmemory << " power of two too large!" << endl;
+            exit(EXIT_FAILURE);
+        }
+        indexMax = (ptrdiff_t)pow(2., powbckmemory);
+        tags = allocate<unsigned char>(indexMax);
+        addresses = allocate<void*>(indexMax);
+        contents = allocate<Long>(indexMax);
+        if (!tags || !addresses || !contents) {
+            cerr << "trail stack out of memory!" << endl;
+            exit(EXIT_FAILURE);
+        }
+        index = 0;
+        base = 0;
+        if (ToulBar2::verbose > 0) {
+            cout << "c " << indexMax * (sizeof(unsigned char) + sizeof(void*) + sizeof(Long)) << " Bytes allocated for trail stack." << endl;
+        }
+    }
+
+    ~StoreTrail()
+    {
+        deallocate(tags, indexMax);
+        deallocate(addresses, indexMax);
+        deallocate(contents, indexMax);
+    }
+
+    void store(Value* x)
+    {
+        if (index > 0)
+            push(TRAIL_VALUE, x, *x);
+    }
+
+#ifndef INT_COST
+    void store(Cost* x)
+    {
+        if (index > 0) {
+            Long y;
+            static_assert(sizeof(Cost) <= sizeof(Long), "costs must fit into trail entries");
+            memcpy(&y, x, sizeof(Cost));
+            push(TRAIL_COST, x, y);
+        }
+    }
+#endif
+
+    void store(BitWord* x)
+    {
+        if (index > 0)
+            push(TRAIL_BITS, x, (Long)*x);
+    }
+
+    template <class Q>
+    void store(BTList<Q>* l, DLink<Q>* elt);
+
+    void store(StoreCostTable* table)
+    {
+        if (index > 0)
+            push(TRAIL_PAGE, table, 0);
+    }
+
+    void store()
+    {
+        push(TRAIL_LEVEL, NULL, base);
+        base = index;
+    }
+
+    void restore()
+    {
+        if (index > 0) { // do nothing if already at depth = 0
+            ptrdiff_t x, y;
+
+            x = index + 1;
+            y = base;
+            while (--x != y) {
+                switch (tags[x]) {
+                case TRAIL_VALUE:
+                    *(Value*)addresses[x] = (Value)contents[x];
+                    break;
+#ifndef INT_COST
+                case TRAIL_COST:
+                    memcpy(addresses[x], &contents[x], sizeof(Cost));
+                    break;
+#endif
+                case TRAIL_DOMAIN:
+                    restoreList<Value>(x);
+                    break;
+                case TRAIL_CONSTRAINT:
+                    restoreList<ConstraintLink>(x);
+                    break;
+                case TRAIL_VARIABLE:
+                    restoreList<Variable*>(x);
+                    break;
+                case TRAIL_SEPARATOR:
+                    restoreList<Separator*>(x);
+                    break;
+                case TRAIL_PAGE:
+                    restorePage(x);
+                    break;
+                case TRAIL_BITS:
+                    *(BitWord*)addresses[x] = (BitWord)contents[x];
+                    break;
+                default:
+                    assert(false);
+                }
+            }
+
+            index = y - 1;
+            base = (ptrdiff_t)contents[y];
+        }
+    }
+};
+
+template <class Q>
+struct StoreTrailTag {
+    static const StoreTrail::Tag tag = StoreTrail::TRAIL_LEVEL; // lists of other element types cannot be trailed (see Queue)
+};
+template <>
+struct StoreTrailTag<Value> {
+    static const StoreTrail::Tag tag = StoreTrail::TRAIL_DOMAIN;
+};
+template <>
+struct StoreTrailTag<ConstraintLink> {
+    static const StoreTrail::Tag tag = StoreTrail::TRAIL_CONSTRAINT;
+};
+template <>
+struct StoreTrailTag<Variable*> {
+    static const StoreTrail::Tag tag = StoreTrail::TRAIL_VARIABLE;
+};
+template <>
+struct StoreTrailTag<Separator*> {
+    static const StoreTrail::Tag tag = StoreTrail::TRAIL_SEPARATOR;
+};
+
+template <class Q>
+void StoreTrail::store(BTList<Q>* l, DLink<Q>* elt)
+{
+    if (index > 0) {
+        assert(StoreTrailTag<Q>::tag != TRAIL_LEVEL);
+        push(StoreTrailTag<Q>::tag, l, (Long)(intptr_t)elt);
+    }
+}
+
 /*
  * Storable basic types
  */
@@ -232,7 +480,7 @@ public:
     StoreBasic& operator=(const StoreBasic& elt)
     { ///< \note assignment has to be backtrackable
         if (&elt != this) {
-            mystore.store(&v);
+            trail(&v);
             v = elt.v;
         }
         return *this;
@@ -240,23 +488,25 @@ public:
 
     StoreBasic& operator=(const T vv)
     {
-        mystore.store(&v);
+        trail(&v);
         v = vv;
         return *this;
     }
     StoreBasic& operator+=(const T vv)
     {
-        mystore.store(&v);
+        trail(&v);
         v += vv;
         return *this;
     }
     StoreBasic& operator-=(const T vv)
     {
-        mystore.store(&v);
+        trail(&v);
         v -= vv;
         return *this;
     }
 
+    static void trail(T* x) { mystore.store(x); } ///< \note specialized for ::Value and ::Cost which use Store::trail instead
+
     static StoreStack<T, T> mystore;
 };
 
@@ -268,6 +518,13 @@ typedef StoreValue StoreInt;
 typedef StoreBasic<Cost> StoreCost;
 typedef StoreBasic<BigInteger> StoreBigInteger;
 
+/// \brief direct read-only access to a vector of storable costs (e.g. for vectorized loops)
+inline const Cost* costData(const vector<StoreCost>& v)
+{
+    static_assert(sizeof(StoreCost) == sizeof(Cost), "a storable cost must have the layout of a cost");
+    return reinterpret_cast<const Cost*>(v.data());
+}
+
 /*
  * Container for all storable stacks
  */
@@ -277,10 +534,7 @@ protected:
 
 public:
     static int depth;
-    static StoreStack<BTList<Value>, DLink<Value>*> storeDomain;
-    static StoreStack<BTList<ConstraintLink>, DLink<ConstraintLink>*> storeConstraint;
-    static StoreStack<BTList<Variable*>, DLink<Variable*>*> storeVariable;
-    static StoreStack<BTList<Separator*>, DLink<Separator*>*> storeSeparator;
+    static StoreTrail trail;
 
     /// \return the current (backtrack / tree search) depth
     static int getDepth()
@@ -292,26 +546,16 @@ public:
     static void store()
     {
         depth++;
-        StoreValue::store();
-        StoreCost::store();
+        trail.store();
         StoreBigInteger::store();
-        storeDomain.store();
-        storeConstraint.store();
-        storeVariable.store();
-        storeSeparator.store();
     }
 
     /// restores the current state to the last copy
     static void restore()
     {
         depth--;
-        StoreValue::restore();
-        StoreCost::restore();
+        trail.restore();
         StoreBigInteger::restore();
-        storeDomain.restore();
-        storeConstraint.restore();
-        storeVariable.restore();
-        storeSeparator.restore();
     }
 
     /// restore the current state to the copy made at depth \c newDepth
@@ -323,7 +567,197 @@ public:
     }
 };
 
-#define storeIndexList storeDomain
+template <>
+inline void StoreBasic<Value>::trail(Value* x)
+{
+    Store::trail.store(x);
+}
+
+#ifndef INT_COST
+template <>
+inline void StoreBasic<Cost>::trail(Cost* x)
+{
+    Store::trail.store(x);
+}
+#endif
+
+/*
+ * Storable table of costs, trailed cost by cost or checkpointed by copy-on-write pages
+ * (or sparse table of the costs different from a default cost, trailed cost by cost)
+ *
+ */
+class StoreCostTable {
+    struct Copy {
+        size_t page;
+        int depth; // previous depth of the page
+        size_t size; // number of copied costs
+    };
+
+    vector<Cost> values;
+    bool paged; // if true, a page is copied at its first modification at a given depth instead of trailing each modified cost
+    vector<int> pageDepth; // depth of the last copy of each page
+    vector<Cost> copies; // stack of copied pages
+    vector<Copy> copied;
+    bool sparse; // if true, only the costs different from defaultCost are stored (in a node-based hash table keeping their address for trailing)
+    size_t sparseSize;
+    Cost defaultCost;
+    std::unordered_map<size_t, Cost> exceptions;
+    vector<uint64_t> stored; // one bit per cost telling if it is in exceptions (avoids hashing default costs)
+
+    Cost get(size_t i) const
+    {
+        if (!sparse)
+            return values[i];
+        if (!(stored[i >> 6] & ((uint64_t)1 << (i & 63))))
+            return defaultCost;
+        std::unordered_map<size_t, Cost>::const_iterator it = exceptions.find(i);
+        return (it == exceptions.end()) ? defaultCost : it->second;
+    }
+
+    // trails the cost at position i before modifying it
+    Cost& cell(size_t i)
+    {
+        if (sparse) {
+            stored[i >> 6] |= ((uint64_t)1 << (i & 63));
+            Cost& c = exceptions.insert(std::make_pair(i, defaultCost)).first->second;
+            Store::trail.store(&c);
+            return c;
+        }
+        trail(i);
+        return values[i];
+    }
+
+    void trail(size_t i)
+    {
+        if (!paged) {
+            Store::trail.store(&values[i]);
+        } else if (pageDepth[i >> PAGE_BITS] < Store::getDepth()) {
+            checkpoint(i >> PAGE_BITS);
+        }
+    }
+
+    void checkpoint(size_t page)
+    {
+        size_t first = page << PAGE_BITS;
+        Copy c = { page, pageDepth[page], min(values.size(), first + PAGE_COSTS) - first };
+        copies.insert(copies.end(), values.begin() + first, values.begin() + first + c.size);
+        copied.push_back(c);
+        pageDepth[page] = Store::getDepth();
+        Store::trail.store(this);
+        totalSize += c.size * sizeof(Cost);
+        if (totalSize > maxSize)
+            maxSize = totalSize;
+    }
+
+public:
+    static const int PAGE_BITS = 9;
+    static const size_t PAGE_COSTS = (1 << PAGE_BITS); // number of costs per page (4KB with 64-bit costs)
+    static Long totalSize; // memory used by page copies of all tables (in bytes)
+    static Long maxSize;
+
+    class reference {
+        StoreCostTable& table;
+        size_t i;
+
+    public:
+        reference(StoreCostTable& t, size_t i_)
+            : table(t)
+            , i(i_)
+        {
+        }
+
+        operator Cost() const { return table.get(i); }
+
+        reference& operator=(const Cost c)
+        { ///< \note assignment has to be backtrackable
+            table.cell(i) = c;
+            return *this;
+        }
+        reference& operator=(const reference& r) { return operator=((Cost)r); }
+        reference& operator+=(const Cost c)
+        {
+            table.cell(i) += c;
+            return *this;
+        }
+        reference& operator-=(const Cost c)
+        {
+            table.cell(i) -= c;
+            return *this;
+        }
+    };
+
+    StoreCostTable()
+        : paged(false)
+        , sparse(false)
+        , sparseSize(0)
+        , defaultCost(MIN_COST)
+    {
+    }
+
+    /// \brief selects copy-on-write checkpointing by pages instead of trailing
+    /// \warning must be called before filling the table
+    void setPaged(bool p)
+    {
+        assert(values.empty());
+        paged = p;
+    }
+    bool isPaged() const { return paged; }
+    bool isSparse() const { return sparse; }
+
+    size_t size() const { return (sparse) ? sparseSize : values.size(); }
+    bool empty() const { return size() == 0; }
+
+    /// \warning not a backtrackable operation
+    void assign(size_t n, Cost c)
+    {
+        assert(!sparse);
+        values.assign(n, c);
+        pageDepth.assign((n + PAGE_COSTS - 1) >> PAGE_BITS, 0);
+    }
+    /// \brief makes a sparse table of \a n costs all equal to \a c (other costs are stored when modified)
+    /// \warning not a backtrackable operation, incompatible with copy-on-write pages
+    void assignSparse(size_t n, Cost c)
+    {
+        assert(!paged && values.empty());
+        sparse = true;
+        sparseSize = n;
+        defaultCost = c;
+        exceptions.clear();
+        stored.assign((n + 63) >> 6, 0);
+    }
+    /// \warning not a backtrackable operation
+    void resize(size_t n, Cost c)
+    {
+        assert(!sparse);
+        values.resize(n, c);
+        pageDepth.resize((n + PAGE_COSTS - 1) >> PAGE_BITS, 0);
+    }
+
+    Cost operator[](size_t i) const { return get(i); }
+    reference operator[](size_t i) { return reference(*this, i); }
+    const Cost* data() const { return (sparse) ? NULL : values.data(); } ///< \warning read-only access (NULL for a sparse table)
+    /// \return memory used by the stored costs (in bytes)
+    Long space() const { return (sparse) ? (Long)exceptions.size() * (sizeof(size_t) + sizeof(Cost)) + (Long)stored.size() * sizeof(uint64_t) : (Long)values.size() * sizeof(Cost); }
+
+    /// \brief undoes the last page copy
+    void restorePage()
+    {
+        assert(!copied.empty());
+        Copy c = copied.back();
+        copied.pop_back();
+        assert(copies.size() >= c.size);
+        size_t first = c.page << PAGE_BITS;
+        std::copy(copies.end() - c.size, copies.end(), values.begin() + first);
+        copies.resize(copies.size() - c.size);
+        pageDepth[c.page] = c.depth;
+        totalSize -= c.size * sizeof(Cost);
+    }
+};
+
+inline void StoreTrail::restorePage(ptrdiff_t x)
+{
+    ((StoreCostTable*)addresses[x])->restorePage();
+}
 
 #endif /*TB2STORE_HPP_*/
 
@@ -0,0 +1,56 @@
+/** \file tb2threads.hpp
+ *  \brief Data-parallel loops over independent tasks using C++11 threads.
+ *
+ *  Tasks must only read shared data (or write to their own part of it) and must not modify the cost function network.
+ */
+
+#ifndef TB2THREADS_HPP_
+#define TB2THREADS_HPP_
+
+#include "core/tb2types.hpp"
+
+#include <atomic>
+#include <thread>
+
+/// \return the number of threads used by parallel loops (ToulBar2::nbThreads or the number of cores if zero)
+inline int getNbThreads()
+{
+    if (ToulBar2::nbThreads > 0)
+        return ToulBar2::nbThreads;
+    int nbcores = std::thread::hardware_concurrency();
+    return max(1, nbcores);
+}
+
+/// \brief calls \a task(i) for all i in [0, \a n), tasks being taken in increasing order by at most \a nbThreads threads (including the calling thread)
+template <typename Task>
+void parallelFor(size_t n, int nbThreads, Task task)
+{
+    if ((size_t)nbThreads > n)
+        nbThreads = n;
+    if (nbThreads <= 1) {
+        for (size_t i = 0; i < n; i++)
+            task(i);
+        return;
+    }
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next++) < n)
+            task(i);
+    };
+    vector<std::thread> threads;
+    for (int t = 1; t < nbThreads; t++)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+#endif /*TB2THREADS_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */